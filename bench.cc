@@ -0,0 +1,279 @@
+//
+// micro-benchmarks comparing the static types against the generic runtime code they replace
+//
+// run the optimized build (exec/opt/bench) -- timings from the debug build are meaningless
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "static_types.h"
+#include "static_mlp.h"
+#include "static_fix.h"
+#include "static_poly.h"
+
+// time fn_ over iters_ calls, each handling items_ items, and print the mean cost per item
+template <typename FN>
+void report(const char *name_, size_t iters_, size_t items_, FN fn_)
+{
+  auto start = std::chrono::steady_clock::now();
+  for(size_t i = 0 ; i < iters_ ; ++i) {
+    fn_(i);
+  }
+  auto end = std::chrono::steady_clock::now();
+  double ns = std::chrono::duration<double, std::nano>(end - start).count() / (iters_ * items_);
+  printf("%-36s %10.2f ns/item\n", name_, ns);
+}
+
+//
+// a 16 -> 16 -> 8 -> 1 scoring net, as tmlp and as a generic loop over vectors
+//
+
+// 16 -> 16
+#define LAYER1_WEIGHTS \
+        -0.698, -0.855, -0.269, 0.015, -0.133, -0.819, 0.654, -0.554, 0.895, -0.207, -0.907, -0.421, -0.764, 0.632, 0.163, -0.255, \
+        -0.874, -0.588, -0.145, 0.171, -0.4, 0.398, 0.149, 0.75, -0.424, -0.764, 0.514, -0.022, 0.336, 0.146, -0.373, 0.189, \
+        -0.088, 0.889, 0.328, 0.403, 0.986, -0.431, 0.337, -0.077, -0.766, 0.536, -0.505, 0.743, -0.102, 0.767, 0.728, -0.169, \
+        0.768, -0.698, -0.536, -0.03, -0.475, -0.162, 0.133, 0.381, 0.235, -0.892, 0.56, 0.596, -0.202, 0.269, -0.865, -0.675, \
+        -0.895, -0.697, -0.273, 0.749, -0.703, -0.305, -0.754, 0.986, -0.032, -0.796, -0.47, -0.677, 0.902, -0.707, -0.946, 0.957, \
+        0.392, -0.267, 0.544, 0.558, -0.554, 0.97, 0.612, 0.48, 0.035, -0.942, -0.441, 0.385, -0.106, 0.976, -0.271, -0.546, \
+        -0.591, 0.801, -0.041, 0.599, 0.321, 0.565, -0.044, 0.578, 0.602, -0.208, 0.894, -0.66, -0.698, 0.613, 0.653, 0.315, \
+        0.097, -0.972, 0.299, 0.867, 0.743, -0.578, -0.414, 0.173, -0.162, 0.82, -0.084, 0.809, 0.835, 0.064, -0.963, -0.634, \
+        0.598, -0.053, 0.113, 0.037, 0.569, 0.121, -0.446, 0.015, 0.52, -0.114, 0.011, 0.385, 0.067, 0.883, 0.753, -0.481, \
+        0.887, -0.726, -0.116, -0.519, 0.339, 0.794, 0.432, -0.714, 0.935, 0.905, -0.025, 0.665, -0.137, -0.322, -0.363, -0.961, \
+        -0.119, -0.337, 0.025, 0.97, 0.943, -0.469, 0.558, -0.741, 0.823, -0.483, 0.838, 0.401, -0.885, -0.149, 0.877, 0.603, \
+        0.712, 0.726, -0.322, 0.853, -0.742, -0.523, -0.677, -0.596, -0.39, -0.42, -0.644, -0.964, -0.969, 0.102, -0.05, -0.787, \
+        -0.136, 0.669, 0.013, 0.965, 0.665, 0.272, -0.305, -0.74, 0.482, -0.674, 0.683, 0.341, -0.516, -0.081, -0.108, 0.924, \
+        0.094, 0.931, -0.287, -0.237, 0.006, 0.009, -0.472, -0.201, -0.955, -0.534, 0.058, 0.315, 0.758, -0.348, -0.701, 0.286, \
+        0.671, 0.255, 0.624, 0.048, 0.67, 0.653, 0.786, 0.387, -0.938, -0.279, 0.672, 0.256, 0.361, -0.993, 0.497, 0.07, \
+        -0.868, -0.496, -0.469, -0.59, 0.951, -0.235, 0.367, 0.234, -0.845, -0.492, -0.391, -0.975, -0.462, 0.384, -0.418, -0.071
+#define LAYER1_BIASES -0.763, -0.601, 0.873, -0.082, 0.936, -0.463, 0.891, 0.163, 0.048, -0.735, 0.017, 0.407, 0.795, -0.95, -0.017, -0.396
+
+// 16 -> 8
+#define LAYER2_WEIGHTS \
+        0.0, 0.0, 0.0, -0.997, 0.678, 0.0, 0.426, -0.42, 0.0, 0.0, 0.178, 0.0, 0.0, 0.0, 0.0, 0.0, \
+        -0.429, -0.501, 0.0, 0.0, 0.0, 0.0, 0.769, 0.262, 0.881, 0.0, -0.901, -0.098, 0.289, 0.0, 0.0, -0.745, \
+        0.0, 0.0, 0.0, 0.953, 0.0, -0.398, 0.0, 0.0, 0.0, 0.0, 0.0, -0.006, 0.0, 0.993, 0.0, 0.0, \
+        0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.499, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, -0.748, \
+        0.0, 0.726, 0.0, 0.0, 0.0, 0.0, 0.0, 0.697, -0.956, 0.0, 0.791, 0.0, 0.0, 0.0, 0.0, 0.651, \
+        0.944, 0.0, 0.0, 0.0, 0.0, 0.883, 0.295, -0.085, 0.0, 0.0, -0.535, 0.291, 0.0, 0.0, 0.0, 0.397, \
+        0.0, 0.0, 0.0, 0.0, 0.0, 0.0, -0.979, 0.0, 0.0, 0.289, -0.049, 0.0, 0.0, 0.409, 0.0, 0.0, \
+        0.0, -0.16, 0.0, 0.85, 0.0, 0.0, 0.0, 0.0, -0.604, 0.478, 0.0, 0.0, -0.377, -0.538, 0.0, -0.41
+#define LAYER2_BIASES -0.008, -0.553, 0.331, -0.707, -0.574, -0.716, -0.88, 0.796
+
+// 8 -> 1
+#define LAYER3_WEIGHTS \
+        0.465, 0.863, -0.629, 0.493, 0.329, -0.252, -0.661, -0.44
+#define LAYER3_BIASES 0.911
+
+typedef tmlp<tlayer<16, 16, tlist<double, LAYER1_WEIGHTS>, tlist<double, LAYER1_BIASES>, trelu>,
+	     tlayer<16, 8, tlist<double, LAYER2_WEIGHTS>, tlist<double, LAYER2_BIASES>, trelu>,
+	     tlayer<8, 1, tlist<double, LAYER3_WEIGHTS>, tlist<double, LAYER3_BIASES>, tidentity>> bench_net;
+
+struct generic_layer
+{
+  size_t in;
+  size_t out;
+  std::vector<double> weights;
+  std::vector<double> biases;
+  bool relu;
+};
+
+void generic_eval(const std::vector<generic_layer> &layers_, const double *in_, double *out_)
+{
+  std::vector<double> cur(in_, in_ + layers_.front().in);
+  std::vector<double> next;
+  for(const auto &layer : layers_) {
+    next.assign(layer.biases.begin(), layer.biases.end());
+    for(size_t o = 0 ; o < layer.out ; ++o) {
+      for(size_t i = 0 ; i < layer.in ; ++i) {
+	next[o] += layer.weights[o * layer.in + i] * cur[i];
+      }
+      if(layer.relu && next[o] < 0) {
+	next[o] = 0;
+      }
+    }
+    cur.swap(next);
+  }
+  std::copy(cur.begin(), cur.end(), out_);
+}
+
+void bench_mlp()
+{
+  std::vector<generic_layer> layers = {
+    {16, 16, {LAYER1_WEIGHTS}, {LAYER1_BIASES}, true},
+    {16, 8, {LAYER2_WEIGHTS}, {LAYER2_BIASES}, true},
+    {8, 1, {LAYER3_WEIGHTS}, {LAYER3_BIASES}, false}
+  };
+
+  constexpr size_t samples = 1024;
+  std::mt19937_64 rng(42);
+  std::uniform_real_distribution<double> dist(-1, 1);
+  std::vector<double> features(samples * 16);
+  for(auto &f : features) {
+    f = dist(rng);
+  }
+
+  std::vector<double> scores(samples);
+  double check_static = 0;
+  double check_generic = 0;
+
+  report("mlp static (tmlp::eval)", 1000000, 1, [&](size_t i) {
+      bench_net::eval(&features[(i % samples) * 16], &scores[i % samples]);
+      check_static += scores[i % samples];
+    });
+  report("mlp static (tmlp::eval_batch)", 1000000 / samples, samples, [&](size_t) {
+      bench_net::eval_batch(features.data(), samples, scores.data());
+    });
+  report("mlp generic loop", 1000000, 1, [&](size_t i) {
+      generic_eval(layers, &features[(i % samples) * 16], &scores[i % samples]);
+      check_generic += scores[i % samples];
+    });
+  printf("(checksums %g %g)\n", check_static, check_generic);
+}
+
+//
+// pulling 12 tags out of a 60 tag fix message, with tfix_parser and with a generic
+// parse into an unordered_map
+//
+
+typedef tfix_parser<tlist<int, 8, 35, 49, 56, 34, 52, 11, 55, 54, 38, 40, 44>> bench_fix_parser;
+
+size_t generic_fix_parse(std::string_view msg_, std::unordered_map<int, std::string_view> &fields_)
+{
+  fields_.clear();
+  size_t i = 0;
+  while(i < msg_.size()) {
+    size_t eq = msg_.find('=', i);
+    size_t end = msg_.find('\x01', eq);
+    if(eq == std::string_view::npos) {
+      break;
+    }
+    if(end == std::string_view::npos) {
+      end = msg_.size();
+    }
+    fields_[std::stoi(std::string(msg_.substr(i, eq - i)))] = msg_.substr(eq + 1, end - eq - 1);
+    i = end + 1;
+  }
+  return fields_.size();
+}
+
+void bench_fix()
+{
+  const int wanted[] = {8, 35, 49, 56, 34, 52, 11, 55, 54, 38, 40, 44};
+  std::string msg;
+  for(int tag : wanted) {
+    msg += std::to_string(tag) + "=value" + std::to_string(tag) + '\x01';
+  }
+  for(int tag = 5000 ; tag < 5048 ; ++tag) {
+    msg += std::to_string(tag) + "=some_unwanted_payload_" + std::to_string(tag) + '\x01';
+  }
+
+  bench_fix_parser parser;
+  std::unordered_map<int, std::string_view> fields;
+  size_t check_static = 0;
+  size_t check_generic = 0;
+
+  report("fix static (tfix_parser)", 200000, 1, [&](size_t) {
+      parser.parse(msg);
+      check_static += parser.get<44>().size() + parser.get<8>().size();
+    });
+  report("fix generic unordered_map", 200000, 1, [&](size_t) {
+      generic_fix_parse(msg, fields);
+      check_generic += fields[44].size() + fields[8].size();
+    });
+  printf("(checksums %zu %zu)\n", check_static, check_generic);
+}
+
+//
+// sweeping a few thousand small models of three kinds, held by type in a tpoly and
+// as a shuffled vector<unique_ptr<base>> with virtual update()
+//
+// the leaf models are final, so tpoly's calls through the concrete type devirtualize and
+// inline -- only the unique_ptr<base> sweep is meant to pay for a virtual call
+//
+
+struct bench_model_base
+{
+  virtual ~bench_model_base() = default;
+  virtual double update(double x_) = 0;
+};
+
+struct bench_ema final : bench_model_base
+{
+  double alpha;
+  double value = 0;
+  explicit bench_ema(double alpha_) : alpha(alpha_) {}
+  double update(double x_) override { return value += alpha * (x_ - value); }
+};
+
+struct bench_linear final : bench_model_base
+{
+  double slope;
+  double offset;
+  bench_linear(double slope_, double offset_) : slope(slope_), offset(offset_) {}
+  double update(double x_) override { return slope * x_ + offset; }
+};
+
+struct bench_clip final : bench_model_base
+{
+  double lo;
+  double hi;
+  bench_clip(double lo_, double hi_) : lo(lo_), hi(hi_) {}
+  double update(double x_) override { return x_ < lo ? lo : x_ > hi ? hi : x_; }
+};
+
+void bench_poly()
+{
+  constexpr size_t models = 3000;
+  tpoly<bench_ema, bench_linear, bench_clip> poly;
+  std::vector<std::unique_ptr<bench_model_base>> pointers;
+  for(size_t i = 0 ; i < models ; ++i) {
+    double p = double(i % 97) / 97;
+    switch(i % 3) {
+    case 0:
+      poly.emplace<bench_ema>(p);
+      pointers.push_back(std::make_unique<bench_ema>(p));
+      break;
+    case 1:
+      poly.emplace<bench_linear>(p, 1 - p);
+      pointers.push_back(std::make_unique<bench_linear>(p, 1 - p));
+      break;
+    default:
+      poly.emplace<bench_clip>(-p, p);
+      pointers.push_back(std::make_unique<bench_clip>(-p, p));
+      break;
+    }
+  }
+  std::shuffle(pointers.begin(), pointers.end(), std::mt19937_64(42));
+
+  double check_static = 0;
+  double check_generic = 0;
+
+  report("poly static (tpoly::visit)", 20000, models, [&](size_t i) {
+      double x = double(i % 13) / 13;
+      poly.visit([&](auto &m) { check_static += m.update(x); });
+    });
+  report("poly virtual (unique_ptr<base>)", 20000, models, [&](size_t i) {
+      double x = double(i % 13) / 13;
+      for(auto &m : pointers) {
+	check_generic += m->update(x);
+      }
+    });
+  printf("(checksums %g %g)\n", check_static, check_generic);
+}
+
+int main(int argc, char **argv)
+{
+  bench_mlp();
+  bench_fix();
+  bench_poly();
+  return 0;
+}
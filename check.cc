@@ -0,0 +1,154 @@
+//
+// runtime checks for what test.cc's static_asserts can't reach: the simd paths (which only
+// run outside constant evaluation), anything that throws, and threads
+//
+// ./exec/opt/check prints each failed check and returns the number of failures -- build
+// with -mavx2 (or -march=native) to check the avx2 paths as well
+//
+
+#include <stdio.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "static_types.h"
+#include "static_quant.h"
+#include "static_match.h"
+#include "static_fix.h"
+#include "static_freeze.h"
+#include "static_telemetry.h"
+#include "static_fsm.h"
+
+constexpr auto check_quant_weights = [] {
+  std::vector<double> w;
+  for(int i = 0 ; i < 75 ; ++i) {
+    w.push_back((i % 11) * 0.1 - 0.5);
+  }
+  return w;
+};
+
+// dot() against a scalar sum over more values than one simd block
+bool check_quant_dot(int seed_)
+{
+  typedef tqlist<tfreeze_t<check_quant_weights>> weights8;
+  typedef tqlist<tfreeze_t<check_quant_weights>, int16_t> weights16;
+  uint8_t x8[weights8::size()];
+  int16_t x16[weights16::size()];
+  int32_t expect8 = 0, expect16 = 0;
+  for(size_t i = 0 ; i < weights8::size() ; ++i) {
+    x8[i] = uint8_t((i * 37 + seed_) % 128);
+    x16[i] = int16_t((i * 101 + seed_) % 2000 - 1000);
+    expect8 += weights8::values[i] * x8[i];
+    expect16 += weights16::values[i] * x16[i];
+  }
+  return weights8::dot(x8) == expect8 && weights16::dot(x16) == expect16;
+}
+
+typedef tstrlist<tstr("he"), tstr("she"), tstr("his"), tstr("hers")> check_patterns;
+
+// long runs of bytes that can't start a pattern, for the simd skip, with "she" and "he"
+// split across two buffers
+bool check_match_stream()
+{
+  std::string first = std::string(40, 'x') + "us";
+  std::string second = "he" + std::string(40, 'x') + "his" + std::string(20, 'x');
+  tmatcher<check_patterns>::stream scan;
+  uint64_t found = 0;
+  size_t ends = 0;
+  auto record = [&](size_t pattern_, size_t end_) { found |= 1 << pattern_; ends += end_; };
+  size_t count = scan.find_all(first.data(), first.size(), record);
+  count += scan.find_all(second.data(), second.size(), record);
+  return count == 3 && found == 0b0111 && ends == 2 + 2 + 45 &&
+    tmatcher<check_patterns>::contains_any(second) && !tmatcher<check_patterns>::contains_any(first);
+}
+
+// values long enough for the simd delimiter scan
+bool check_fix_parse()
+{
+  tfix_parser<tlist<int, 35, 44, 58>, '|'> parser;
+  std::string msg = "8=FIX.4.4|35=D|58=" + std::string(40, 'x') + "|9999=" + std::string(20, 'y') + "|44=101.25|";
+  return parser.parse(msg) == 3 && parser.get<58>() == std::string(40, 'x') && parser.get<44>() == "101.25" && parser.get<35>() == "D";
+}
+
+// a batch with fewer outputs than keys is refused rather than written past its end
+bool check_lookup_batch()
+{
+  typedef tmap<int64_t, int, std::pair<tval<int64_t(5)>, tval<1>>, std::pair<tval<int64_t(6)>, tval<2>>> map;
+  const int64_t keys[] = {5, 6, 7};
+  int out[2] = {};
+  try {
+    map().lookup_batch(keys, out);
+  } catch(const std::out_of_range &) {
+    return out[0] == 0 && out[1] == 0;
+  }
+  return false;
+}
+
+enum class check_state { idle, live, done };
+enum class check_event { start, stop };
+
+typedef tfsm<check_state::idle,
+	     ttransition<check_state::idle, check_event::start, check_state::live>,
+	     ttransition<check_state::live, check_event::stop, check_state::done>> check_fsm;
+
+// a state outside the machine is refused rather than used to index its table
+bool check_fsm_reset()
+{
+  check_fsm fsm;
+  fsm.reset(check_state::live);
+  try {
+    fsm.reset(check_state(7));
+  } catch(const std::out_of_range &) {
+    return fsm.state() == check_state::live && fsm.process(check_event::stop) && !fsm.process(check_event(9));
+  }
+  return false;
+}
+
+typedef tcounters<tstrlist<tstr("updates"), tstr("rejects")>> check_counters;
+typedef thistogram<thdr_bounds<2, 1000>> check_latency;
+
+// waves of short-lived threads, more of them at once than there are inline slots, with an
+// aggregator collecting as they go -- slots are reused, so every count survives
+bool check_telemetry()
+{
+  typedef tper_thread<check_counters, void, 4> counters;
+  typedef tper_thread<check_latency, void, 4> latency;
+  std::atomic<uint64_t> reported{0};
+  {
+    taggregator report(std::chrono::milliseconds(1), [&reported] { reported = counters::collect()[0]; });
+    for(int wave = 0 ; wave < 50 ; ++wave) {
+      std::vector<std::jthread> threads;
+      for(int i = 0 ; i < 6 ; ++i) {
+	threads.emplace_back([] {
+	  counters::local().add<tstr("updates")>();
+	  latency::local().record(9);
+	});
+      }
+    }
+  }
+  auto histogram = latency::collect();
+  return reported == 300 && histogram.count() == 300 && histogram.counts[8] == 300 && counters::threads() <= 6;
+}
+
+int main(int argc, char **argv)
+{
+  int failures = 0;
+  auto check = [&failures](const char *name_, bool ok_) {
+    if(!ok_) {
+      printf("FAILED: %s\n", name_);
+      ++failures;
+    }
+  };
+
+  check("tqlist dot", check_quant_dot(argc));
+  check("tmatcher stream", check_match_stream());
+  check("tfix_parser parse", check_fix_parse());
+  check("tmap lookup_batch", check_lookup_batch());
+  check("tfsm reset", check_fsm_reset());
+  check("tper_thread and taggregator", check_telemetry());
+
+  return failures;
+}
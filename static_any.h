@@ -0,0 +1,233 @@
+#ifndef __STATIC_ANY_H__
+#define __STATIC_ANY_H__
+
+#include <array>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "static_types.h"
+
+// a handle to one object whose type comes from a closed thlist, stored inline (no heap
+// allocation) with a one-byte tag saying which type it is
+//
+// typedef tany<thlist<calc_a, calc_b, calc_c>> any_model;
+// any_model m = calc_b(...);
+// m.update();                                    // one indirect call through a table indexed by the tag
+// m.update_batch(x, n);
+// m.visit([](auto &model) { model.update(); });  // the concrete type, inlined per case
+//
+// update() and update_batch() (and any other method, through invoke<METHOD>()) dispatch
+// through a constant table of one function pointer per type, built for the argument
+// types used -- there is no vtable pointer in the object and no heap allocation; visit()
+// instead branches on the tag so each case is the visitor inlined for its type
+//
+// calling anything but has_value()/index() on an empty handle throws std::logic_error
+
+// method selectors for tany::invoke
+struct tupdate_method
+{
+  template <typename T, typename... ARGS>
+    static constexpr decltype(auto) call(T &t_, ARGS &&... args_) { return t_.update(std::forward<ARGS>(args_)...); }
+};
+
+struct tupdate_batch_method
+{
+  template <typename T, typename... ARGS>
+    static constexpr decltype(auto) call(T &t_, ARGS &&... args_) { return t_.update_batch(std::forward<ARGS>(args_)...); }
+};
+
+// the inline storage: a union of every type, so size and alignment are the largest
+template <typename... TYPES>
+union tany_storage
+{
+  constexpr tany_storage() : none() {}
+
+  char none;
+};
+
+template <typename T, typename... REST>
+union tany_storage<T, REST...>
+{
+  constexpr tany_storage() : none() {}
+  constexpr ~tany_storage() {}
+
+  char none;
+  T first;
+  tany_storage<REST...> rest;
+};
+
+template <typename LIST>
+class tany;
+
+template <typename... TYPES>
+class tany<thlist<TYPES...>>
+{
+public:
+  static_assert(sizeof...(TYPES) > 0 && sizeof...(TYPES) < 255, "tany supports 1 to 254 types");
+  static_assert(thlist<TYPES...>::distinct() == sizeof...(TYPES), "tany types must be distinct");
+
+  // the index() of an empty handle
+  static constexpr size_t npos = sizeof...(TYPES);
+
+  template <typename T>
+  static constexpr bool holds_type() { return (std::is_same_v<T, TYPES> || ...); }
+
+  constexpr tany() = default;
+
+  template <typename T> requires (holds_type<std::remove_cvref_t<T>>())
+  constexpr tany(T &&v_) { emplace<std::remove_cvref_t<T>>(std::forward<T>(v_)); }
+
+  constexpr tany(const tany &other_) requires (std::is_copy_constructible_v<TYPES> && ...) {
+    other_.visit_or_empty([this](const auto &v_) { emplace<std::remove_cvref_t<decltype(v_)>>(v_); });
+  }
+
+  constexpr tany(tany &&other_) requires (std::is_move_constructible_v<TYPES> && ...) {
+    other_.visit_or_empty([this](auto &v_) { emplace<std::remove_cvref_t<decltype(v_)>>(std::move(v_)); });
+  }
+
+  constexpr tany &operator=(const tany &other_) requires (std::is_copy_constructible_v<TYPES> && ...) {
+    if(this != &other_) {
+      reset();
+      other_.visit_or_empty([this](const auto &v_) { emplace<std::remove_cvref_t<decltype(v_)>>(v_); });
+    }
+    return *this;
+  }
+
+  constexpr tany &operator=(tany &&other_) requires (std::is_move_constructible_v<TYPES> && ...) {
+    if(this != &other_) {
+      reset();
+      other_.visit_or_empty([this](auto &v_) { emplace<std::remove_cvref_t<decltype(v_)>>(std::move(v_)); });
+    }
+    return *this;
+  }
+
+  constexpr ~tany() { reset(); }
+
+  constexpr bool has_value() const { return _tag != npos; }
+
+  // position in the thlist of the held type, or npos
+  constexpr size_t index() const { return _tag; }
+
+  template <typename T> requires (holds_type<T>())
+  constexpr bool holds() const { return _tag == thlist<TYPES...>::template index_of<T>(); }
+
+  template <typename T, typename... ARGS> requires (holds_type<T>())
+  constexpr T &emplace(ARGS &&... args_) {
+    reset();
+    T &v = construct<thlist<TYPES...>::template index_of<T>()>(_storage, std::forward<ARGS>(args_)...);
+    _tag = uint8_t(thlist<TYPES...>::template index_of<T>());
+    return v;
+  }
+
+  constexpr void reset() {
+    if(has_value()) {
+      visit([](auto &v_) { std::destroy_at(&v_); });
+      _tag = uint8_t(npos);
+    }
+  }
+
+  template <typename T> requires (holds_type<T>())
+  constexpr T &get() {
+    if(!holds<T>()) {
+      throw std::logic_error("tany doesn't hold this type");
+    }
+    return member<thlist<TYPES...>::template index_of<T>()>(_storage);
+  }
+
+  template <typename T> requires (holds_type<T>())
+  constexpr T *get_if() { return holds<T>() ? &member<thlist<TYPES...>::template index_of<T>()>(_storage) : nullptr; }
+
+  // call METHOD::call(object, args_...) on the held object through a per-type table
+  template <typename METHOD, typename... ARGS>
+  constexpr decltype(auto) invoke(ARGS &&... args_) { return tdispatch<METHOD, ARGS...>::table[_tag](*this, std::forward<ARGS>(args_)...); }
+
+  template <typename... ARGS>
+  constexpr decltype(auto) update(ARGS &&... args_) { return invoke<tupdate_method>(std::forward<ARGS>(args_)...); }
+
+  template <typename... ARGS>
+  constexpr decltype(auto) update_batch(ARGS &&... args_) { return invoke<tupdate_batch_method>(std::forward<ARGS>(args_)...); }
+
+  // call visitor_ with the held object as its concrete type
+  template <typename VISITOR>
+  constexpr decltype(auto) visit(VISITOR &&visitor_) { return visit_from<0>(*this, visitor_); }
+
+  template <typename VISITOR>
+  constexpr decltype(auto) visit(VISITOR &&visitor_) const { return visit_from<0>(*this, visitor_); }
+
+private:
+  template <size_t I, typename STORAGE, typename... ARGS>
+  static constexpr auto &construct(STORAGE &s_, ARGS &&... args_) {
+    if constexpr (I == 0) {
+      return *std::construct_at(&s_.first, std::forward<ARGS>(args_)...);
+    } else {
+      std::construct_at(&s_.rest);
+      return construct<I - 1>(s_.rest, std::forward<ARGS>(args_)...);
+    }
+  }
+
+  template <size_t I, typename STORAGE>
+  static constexpr auto &member(STORAGE &s_) {
+    if constexpr (I == 0) {
+      return s_.first;
+    } else {
+      return member<I - 1>(s_.rest);
+    }
+  }
+
+  template <size_t I, typename SELF, typename VISITOR>
+  static constexpr decltype(auto) visit_from(SELF &self_, VISITOR &visitor_) {
+    if constexpr (I + 1 == sizeof...(TYPES)) {
+      if(self_._tag != I) {
+	throw std::logic_error("tany is empty");
+      }
+      return visitor_(member<I>(self_._storage));
+    } else {
+      if(self_._tag == I) {
+	return visitor_(member<I>(self_._storage));
+      }
+      return visit_from<I + 1>(self_, visitor_);
+    }
+  }
+
+  template <typename VISITOR>
+  constexpr void visit_or_empty(VISITOR visitor_) const {
+    if(has_value()) {
+      visit(visitor_);
+    }
+  }
+
+  template <typename VISITOR>
+  constexpr void visit_or_empty(VISITOR visitor_) {
+    if(has_value()) {
+      visit(visitor_);
+    }
+  }
+
+  // one entry per type plus a last one for the empty handle
+  template <typename METHOD, typename... ARGS>
+  struct tdispatch {
+    typedef std::common_type_t<decltype(METHOD::call(std::declval<TYPES &>(), std::declval<ARGS>()...))...> result_type;
+    typedef result_type (*entry_type)(tany &, ARGS &&...);
+
+    template <size_t I>
+    static constexpr result_type call(tany &self_, ARGS &&... args_) {
+      if constexpr (I == sizeof...(TYPES)) {
+	throw std::logic_error("tany is empty");
+      } else {
+	return METHOD::call(member<I>(self_._storage), std::forward<ARGS>(args_)...);
+      }
+    }
+
+    template <size_t... I>
+    static constexpr std::array<entry_type, sizeof...(I)> make(std::index_sequence<I...>) { return {&call<I>...}; }
+
+    static constexpr std::array<entry_type, sizeof...(TYPES) + 1> table = make(std::make_index_sequence<sizeof...(TYPES) + 1>());
+  };
+
+  tany_storage<TYPES...> _storage;
+  uint8_t _tag = uint8_t(npos);
+};
+
+#endif
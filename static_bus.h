@@ -0,0 +1,188 @@
+#ifndef __STATIC_BUS_H__
+#define __STATIC_BUS_H__
+
+#include <array>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "static_types.h"
+
+// a static publish/subscribe event bus: subscriptions are a compile-time list of
+// (tstr topic, handler type) pairs, and the handlers are held by value in a thlist
+//
+// struct on_trade { void operator()(const trade &t_) { ... } };
+// tbus<tsub<tstr("trades"), on_trade>, tsub<tstr("trades"), trade_logger>> bus;
+// bus.publish<tstr("trades")>(t);   // both handlers inlined, no lookup at all
+// bus.publish(topic, t);            // one perfect-hash probe into a jump table
+//
+// handlers are called as handler(msg); a handler that can't take a given message type is
+// skipped when publishing by runtime topic, and is a compile error when publishing by tstr
+
+template <typename TOPIC, typename HANDLER>
+struct tsub
+{
+  typedef TOPIC topic;
+  typedef HANDLER handler_type;
+};
+
+template <typename... SUBS>
+class tbus
+{
+public:
+  static constexpr size_t size() { return sizeof...(SUBS); }
+
+  // number of handlers subscribed to a topic
+  template <typename TOPIC>
+    static constexpr size_t subscribers() {
+    return ((typename SUBS::topic{}() == TOPIC()() ? 1 : 0) + ... + 0);
+  }
+
+  // publish with a constant topic -- resolves to direct calls to the matching handlers
+  template <typename TOPIC, typename MSG>
+    constexpr void publish(const MSG &msg_) {
+    publish_static<TOPIC>(msg_, std::make_index_sequence<size()>());
+  }
+
+  // publish with a runtime topic, returning false if no handler on it takes a MSG (or
+  // nobody subscribes to it at all)
+  template <typename MSG>
+    constexpr bool publish(std::string_view topic_, const MSG &msg_) {
+    const auto &slot = _table<MSG>[slot_of(hash(topic_, _seed))];
+    if(!slot.used || slot.topic != topic_) {
+      return false;
+    }
+    slot.dispatch(*this, msg_);
+    return true;
+  }
+
+  // the handler of the ith subscription
+  template <size_t I> requires (I < sizeof...(SUBS))
+    constexpr auto &handler() { return std::get<I>(_handlers.items); }
+
+private:
+  static constexpr std::array<std::string_view, size()> _topics = {typename SUBS::topic{}()...};
+
+  // distinct topics, in order of first subscription
+  static constexpr size_t unique_count() {
+    size_t n = 0;
+    for(size_t i = 0 ; i < size() ; ++i) {
+      bool seen = false;
+      for(size_t j = 0 ; j < i ; ++j) {
+	seen = seen || _topics[j] == _topics[i];
+      }
+      n += !seen;
+    }
+    return n;
+  }
+
+  static constexpr std::array<std::string_view, unique_count()> _unique = [] {
+    std::array<std::string_view, unique_count()> unique{};
+    size_t n = 0;
+    for(size_t i = 0 ; i < size() ; ++i) {
+      bool seen = false;
+      for(size_t j = 0 ; j < n ; ++j) {
+	seen = seen || unique[j] == _topics[i];
+      }
+      if(!seen) {
+	unique[n++] = _topics[i];
+      }
+    }
+    return unique;
+  }();
+
+  // jump table size: a power of two with at least twice as many slots as topics
+  static constexpr size_t _slots = [] {
+    size_t n = 1;
+    while(n < 2 * unique_count()) {
+      n *= 2;
+    }
+    return n;
+  }();
+
+  static constexpr uint64_t hash(std::string_view s_, uint64_t seed_) {
+    uint64_t h = 14695981039346656037ull ^ seed_;
+    for(char c : s_) {
+      h = (h ^ uint8_t(c)) * 1099511628211ull;
+    }
+    return h ^ (h >> 29);
+  }
+
+  static constexpr size_t slot_of(uint64_t hash_) { return hash_ & (_slots - 1); }
+
+  // the first seed that maps every topic to its own slot
+  static constexpr uint64_t _seed = [] {
+    for(uint64_t seed = 0 ; seed < 100000 ; ++seed) {
+      std::array<bool, _slots> used{};
+      bool ok = true;
+      for(size_t u = 0 ; u < unique_count() && ok ; ++u) {
+	size_t s = slot_of(hash(_unique[u], seed));
+	ok = !used[s];
+	used[s] = true;
+      }
+      if(ok) {
+	return seed;
+      }
+    }
+    throw std::logic_error("no perfect hash seed found for tbus topics");
+  }();
+
+  template <typename TOPIC, typename MSG, size_t... I>
+    constexpr void publish_static(const MSG &msg_, std::index_sequence<I...>) {
+    static_assert(subscribers<TOPIC>() > 0, "nobody subscribes to this topic");
+    ([&] {
+      if constexpr (_topics[I] == TOPIC()()) {
+	std::get<I>(_handlers.items)(msg_);
+      }
+    }(), ...);
+  }
+
+  // call every handler subscribed to the Uth distinct topic
+  template <size_t U, typename MSG>
+    static constexpr void dispatch(tbus &bus_, const MSG &msg_) {
+    dispatch_each<U>(bus_, msg_, std::make_index_sequence<size()>());
+  }
+
+  template <size_t U, typename MSG, size_t... I>
+    static constexpr void dispatch_each(tbus &bus_, const MSG &msg_, std::index_sequence<I...>) {
+    ([&] {
+      typedef std::tuple_element_t<I, std::tuple<typename SUBS::handler_type...>> handler_type;
+      if constexpr (_topics[I] == _unique[U] && std::is_invocable_v<handler_type &, const MSG &>) {
+	std::get<I>(bus_._handlers.items)(msg_);
+      }
+    }(), ...);
+  }
+
+  // does any handler subscribed to the Uth distinct topic take a MSG
+  template <size_t U, typename MSG, size_t... I>
+    static constexpr bool takes(std::index_sequence<I...>) {
+    return ((_topics[I] == _unique[U] &&
+	     std::is_invocable_v<std::tuple_element_t<I, std::tuple<typename SUBS::handler_type...>> &, const MSG &>) || ...);
+  }
+
+  template <typename MSG>
+    struct tslot {
+    bool used;
+    std::string_view topic;
+    void (*dispatch)(tbus &, const MSG &);
+  };
+
+  template <typename MSG, size_t... U>
+    static constexpr std::array<tslot<MSG>, _slots> make_table(std::index_sequence<U...>) {
+    // topics with no handler for MSG get no entry, so publishing MSG to them misses
+    std::array<tslot<MSG>, _slots> table{};
+    ([&] {
+      if constexpr (takes<U, MSG>(std::make_index_sequence<size()>())) {
+	table[slot_of(hash(_unique[U], _seed))] = {true, _unique[U], &dispatch<U, MSG>};
+      }
+    }(), ...);
+    return table;
+  }
+
+  template <typename MSG>
+    static constexpr std::array<tslot<MSG>, _slots> _table = make_table<MSG>(std::make_index_sequence<unique_count()>());
+
+  thlist<typename SUBS::handler_type...> _handlers;
+};
+
+#endif
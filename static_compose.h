@@ -0,0 +1,352 @@
+#ifndef __STATIC_COMPOSE_H__
+#define __STATIC_COMPOSE_H__
+
+#include <array>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "static_types.h"
+
+// compile-time composition of tmaps and tlists: layered configs are folded into one
+// static map by the compiler, so a lookup in the result costs what a lookup in any
+// hand-written tmap does -- there is no chain of fallbacks at runtime
+//
+// typedef tmap<std::string_view, double, std::pair<tstr("max_qty"), tval<100.0>>,
+//                                        std::pair<tstr("tick"), tval<0.25>>> defaults;
+// typedef tmap<std::string_view, double, std::pair<tstr("tick"), tval<0.01>>> venue;
+// typedef toverride_t<defaults, venue> config;        // layers may only change known keys
+// typedef tmerge_t<defaults, venue, instrument> any;  // layers may also add keys
+// typedef trestrict_t<config, tstrlist<tstr("tick")>> ticks_only;
+// static_assert(tdiff<defaults, config>::changed::size() == 1);
+//
+// the same operations work on tlists and tstrlists, where merge is an ordered union,
+// restrict an intersection and tdiff reports the added and removed elements
+//
+// keys and values are compared by value, so tstr("a") written twice is the same key;
+// scalar values are compared through their call operator (tval, tstr) and list values
+// element by element
+
+// are two compile-time constants (tval, tstr, tlist, tstrlist) equal
+template <typename A, typename B>
+constexpr bool tsame_value()
+{
+  if constexpr (std::is_same_v<A, B>) {
+    return true;
+  } else if constexpr (requires { A{}() == B{}(); }) {
+    return A{}() == B{}();
+  } else if constexpr (requires { A::size(); B::size(); A{}[0] == B{}[0]; }) {
+    if(A::size() != B::size()) {
+      return false;
+    }
+    for(size_t i = 0 ; i < A::size() ; ++i) {
+      if(!(A{}[i] == B{}[i])) {
+	return false;
+      }
+    }
+    return true;
+  } else {
+    return false;
+  }
+}
+
+// the list or map made of one operand's elements followed by the other's
+template <typename A, typename B>
+struct tconcat;
+
+template <typename T, T... A, T... B>
+struct tconcat<tlist<T, A...>, tlist<T, B...>> { typedef tlist<T, A..., B...> type; };
+
+template <typename... A, typename... B>
+struct tconcat<tstrlist<A...>, tstrlist<B...>> { typedef tstrlist<A..., B...> type; };
+
+template <typename KEY, typename VALUE, typename... A, typename... B>
+struct tconcat<tmap<KEY, VALUE, A...>, tmap<KEY, VALUE, B...>> { typedef tmap<KEY, VALUE, A..., B...> type; };
+
+template <typename A, typename B>
+using tconcat_t = typename tconcat<A, B>::type;
+
+// element-wise view of a list or map used by the operations below: same_key(i, j) for
+// two elements, same_value(i, j) for what they hold, key_in<KEYS>(i) for membership in a
+// tlist/tstrlist, and select<SELECTED> for the list or map of the chosen elements
+template <typename LIST>
+struct tcompose;
+
+template <typename T, T... ARGS>
+struct tcompose<tlist<T, ARGS...>>
+{
+  static constexpr size_t size() { return sizeof...(ARGS); }
+
+  static constexpr std::array<T, sizeof...(ARGS)> values = {ARGS...};
+
+  static constexpr bool same_key(size_t i_, size_t j_) { return values[i_] == values[j_]; }
+  static constexpr bool same_value(size_t i_, size_t j_) { return same_key(i_, j_); }
+
+  template <typename KEYS>
+    static constexpr bool key_in(size_t i_) {
+    for(size_t j = 0 ; j < KEYS::size() ; ++j) {
+      if(values[i_] == KEYS()[j]) {
+	return true;
+      }
+    }
+    return false;
+  }
+
+  template <auto SELECTED, typename = std::make_index_sequence<SELECTED.size()>>
+    struct tselect;
+
+  template <auto SELECTED, size_t... I>
+    struct tselect<SELECTED, std::index_sequence<I...>> { typedef tlist<T, values[SELECTED[I]]...> type; };
+
+  template <auto SELECTED>
+    using select = typename tselect<SELECTED>::type;
+};
+
+template <typename... ARGS>
+struct tcompose<tstrlist<ARGS...>>
+{
+  static constexpr size_t size() { return sizeof...(ARGS); }
+
+  static constexpr std::array<std::string_view, sizeof...(ARGS)> values = {ARGS{}()...};
+
+  static constexpr bool same_key(size_t i_, size_t j_) { return values[i_] == values[j_]; }
+  static constexpr bool same_value(size_t i_, size_t j_) { return same_key(i_, j_); }
+
+  template <typename KEYS>
+    static constexpr bool key_in(size_t i_) {
+    for(size_t j = 0 ; j < KEYS::size() ; ++j) {
+      if(values[i_] == KEYS()[j]) {
+	return true;
+      }
+    }
+    return false;
+  }
+
+  template <auto SELECTED, typename = std::make_index_sequence<SELECTED.size()>>
+    struct tselect;
+
+  template <auto SELECTED, size_t... I>
+    struct tselect<SELECTED, std::index_sequence<I...>> {
+    typedef tstrlist<std::tuple_element_t<SELECTED[I], std::tuple<ARGS...>>...> type;
+  };
+
+  template <auto SELECTED>
+    using select = typename tselect<SELECTED>::type;
+};
+
+template <typename KEY, typename VALUE, typename... KVPAIRS>
+struct tcompose<tmap<KEY, VALUE, KVPAIRS...>>
+{
+  static constexpr size_t size() { return sizeof...(KVPAIRS); }
+
+  // a tmap's keys may be tstr's (or even std::string's), which can't be held in a
+  // constant array, so both comparisons are tabulated over the pair types instead
+  template <typename KV>
+    static constexpr std::array<bool, sizeof...(KVPAIRS)> key_row = {
+    tsame_value<typename KV::first_type, typename KVPAIRS::first_type>()...
+  };
+
+  template <typename KV>
+    static constexpr std::array<bool, sizeof...(KVPAIRS)> value_row = {
+    tsame_value<typename KV::second_type, typename KVPAIRS::second_type>()...
+  };
+
+  static constexpr std::array<std::array<bool, sizeof...(KVPAIRS)>, sizeof...(KVPAIRS)> keys = {key_row<KVPAIRS>...};
+  static constexpr std::array<std::array<bool, sizeof...(KVPAIRS)>, sizeof...(KVPAIRS)> values = {value_row<KVPAIRS>...};
+
+  static constexpr bool same_key(size_t i_, size_t j_) { return keys[i_][j_]; }
+  static constexpr bool same_value(size_t i_, size_t j_) { return values[i_][j_]; }
+
+  template <typename K, typename KEYS>
+    static constexpr bool key_in_list() {
+    for(size_t j = 0 ; j < KEYS::size() ; ++j) {
+      if(K{}() == KEYS()[j]) {
+	return true;
+      }
+    }
+    return false;
+  }
+
+  template <typename KEYS>
+    static constexpr bool key_in(size_t i_) {
+    constexpr std::array<bool, sizeof...(KVPAIRS)> in = {key_in_list<typename KVPAIRS::first_type, KEYS>()...};
+    return in[i_];
+  }
+
+  template <auto SELECTED, typename = std::make_index_sequence<SELECTED.size()>>
+    struct tselect;
+
+  template <auto SELECTED, size_t... I>
+    struct tselect<SELECTED, std::index_sequence<I...>> {
+    typedef tmap<KEY, VALUE, std::tuple_element_t<SELECTED[I], std::tuple<KVPAIRS...>>...> type;
+  };
+
+  template <auto SELECTED>
+    using select = typename tselect<SELECTED>::type;
+};
+
+// the positions in [0, N) for which KEEP(i) holds, as a constant array
+template <size_t N, auto KEEP>
+struct tpositions
+{
+  static constexpr size_t count = [] {
+    size_t n = 0;
+    for(size_t i = 0 ; i < N ; ++i) {
+      n += KEEP(i);
+    }
+    return n;
+  }();
+
+  static constexpr std::array<size_t, count> value = [] {
+    std::array<size_t, count> selected{};
+    size_t n = 0;
+    for(size_t i = 0 ; i < N ; ++i) {
+      if(KEEP(i)) {
+	selected[n++] = i;
+      }
+    }
+    return selected;
+  }();
+};
+
+// one layer over another: for maps, the keys of both with LAYER's value winning (in
+// BASE's order, then LAYER's new keys); for lists, the elements of both once each
+template <typename BASE, typename LAYER, bool STRICT = false>
+struct tlayer_over
+{
+  typedef tconcat_t<BASE, LAYER> both;
+  typedef tcompose<both> ops;
+
+  static constexpr size_t n_base = tcompose<BASE>::size();
+
+  // the element of both standing in for element i_: the last one with the same key
+  static constexpr size_t winner(size_t i_) {
+    size_t w = i_;
+    for(size_t j = n_base ; j < ops::size() ; ++j) {
+      w = ops::same_key(i_, j) ? j : w;
+    }
+    return w;
+  }
+
+  // was an element with the same key seen before position i_
+  static constexpr bool seen(size_t i_) {
+    for(size_t j = 0 ; j < i_ ; ++j) {
+      if(ops::same_key(i_, j)) {
+	return true;
+      }
+    }
+    return false;
+  }
+
+  static_assert(!STRICT || [] {
+      for(size_t j = n_base ; j < ops::size() ; ++j) {
+	bool known = false;
+	for(size_t i = 0 ; i < n_base ; ++i) {
+	  known = known || ops::same_key(i, j);
+	}
+	if(!known) {
+	  return false;
+	}
+      }
+      return true;
+    }(), "override layer has a key the base doesn't");
+
+  static constexpr auto keep = [](size_t i_) { return !seen(i_); };
+
+  static constexpr std::array<size_t, tpositions<ops::size(), keep>::count> selected = [] {
+    auto selected = tpositions<ops::size(), keep>::value;
+    for(auto &s : selected) {
+      s = s < n_base ? winner(s) : s;
+    }
+    return selected;
+  }();
+
+  typedef typename ops::template select<selected> type;
+};
+
+// BASE with each of LAYERS applied in turn, a later layer winning over an earlier one
+template <typename BASE, typename... LAYERS>
+struct tmerge { typedef BASE type; };
+
+template <typename BASE, typename LAYER, typename... LAYERS>
+struct tmerge<BASE, LAYER, LAYERS...> { typedef typename tmerge<typename tlayer_over<BASE, LAYER>::type, LAYERS...>::type type; };
+
+template <typename BASE, typename... LAYERS>
+using tmerge_t = typename tmerge<BASE, LAYERS...>::type;
+
+// as tmerge, but a layer may only change values of keys BASE already has (a misspelled
+// key in an override is a compile error rather than a silently ignored setting)
+template <typename BASE, typename... LAYERS>
+struct toverride { typedef BASE type; };
+
+template <typename BASE, typename LAYER, typename... LAYERS>
+struct toverride<BASE, LAYER, LAYERS...> { typedef typename toverride<typename tlayer_over<BASE, LAYER, true>::type, LAYERS...>::type type; };
+
+template <typename BASE, typename... LAYERS>
+using toverride_t = typename toverride<BASE, LAYERS...>::type;
+
+// the elements (or pairs) of LIST whose key is in KEYS (a tlist or tstrlist), in LIST's order
+template <typename LIST, typename KEYS, bool IN = true>
+struct trestrict
+{
+  typedef tcompose<LIST> ops;
+
+  static constexpr auto keep = [](size_t i_) { return ops::template key_in<KEYS>(i_) == IN; };
+
+  typedef typename ops::template select<tpositions<ops::size(), keep>::value> type;
+};
+
+template <typename LIST, typename KEYS>
+using trestrict_t = typename trestrict<LIST, KEYS>::type;
+
+// the elements (or pairs) of LIST whose key isn't in KEYS
+template <typename LIST, typename KEYS>
+using texclude_t = typename trestrict<LIST, KEYS, false>::type;
+
+// what changed from FROM to TO, all as types of the same kind as the operands: added
+// (keys only in TO), removed (keys only in FROM) and, for maps, changed (keys in both
+// with different values, holding TO's values)
+template <typename FROM, typename TO>
+struct tdiff
+{
+  typedef tconcat_t<FROM, TO> both;
+  typedef tcompose<both> ops;
+
+  static constexpr size_t n_from = tcompose<FROM>::size();
+
+  // the position in TO of the key at i_ (which is in FROM), or ops::size()
+  static constexpr size_t match(size_t i_) {
+    for(size_t j = n_from ; j < ops::size() ; ++j) {
+      if(ops::same_key(i_, j)) {
+	return j;
+      }
+    }
+    return ops::size();
+  }
+
+  // the position in FROM of the key at j_ (which is in TO), or ops::size()
+  static constexpr size_t rmatch(size_t j_) {
+    for(size_t i = 0 ; i < n_from ; ++i) {
+      if(ops::same_key(i, j_)) {
+	return i;
+      }
+    }
+    return ops::size();
+  }
+
+  static constexpr auto is_added = [](size_t i_) { return i_ >= n_from && rmatch(i_) == ops::size(); };
+  static constexpr auto is_removed = [](size_t i_) { return i_ < n_from && match(i_) == ops::size(); };
+  static constexpr auto is_changed = [](size_t i_) { return i_ >= n_from && rmatch(i_) != ops::size() && !ops::same_value(rmatch(i_), i_); };
+
+  typedef typename ops::template select<tpositions<ops::size(), is_added>::value> added;
+  typedef typename ops::template select<tpositions<ops::size(), is_removed>::value> removed;
+  typedef typename ops::template select<tpositions<ops::size(), is_changed>::value> changed;
+
+  // number of added, removed and changed keys
+  static constexpr size_t size() { return added::size() + removed::size() + changed::size(); }
+
+  static constexpr bool empty() { return size() == 0; }
+};
+
+#endif
@@ -0,0 +1,161 @@
+#ifndef __STATIC_DECODE_H__
+#define __STATIC_DECODE_H__
+
+#include <array>
+#include <bit>
+#include <cstring>
+#include <span>
+#include <tuple>
+#include <type_traits>
+
+#include "static_types.h"
+
+// static binary message layouts: a schema is a compile-time list of (tstr name, offset,
+// type, endianness) fields, and decoding a field is a single unaligned load plus (when the
+// message endianness differs from the host's) one byteswap -- no field table is consulted
+//
+// typedef tschema<tfield<tstr("seq"), 0, uint32_t, tendian::big>,
+//                 tfield<tstr("price"), 4, int64_t, tendian::big>,
+//                 tfield<tstr("qty"), 12, uint32_t, tendian::big>> trade_msg;
+// trade_msg::view msg(bytes);            // zero-copy, checks the span is long enough
+// int64_t px = msg.get<tstr("price")>();
+// trade_msg::decode_column<tstr("price")>(buf, n, stride, prices); // columnar bulk decode
+
+enum class tendian { little, big };
+
+// reverse the bytes of an integral or floating point value
+template <typename T>
+constexpr T tbyteswap(T v_)
+{
+  static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T>, "tbyteswap needs an arithmetic or enum type");
+  if constexpr (sizeof(T) == 1) {
+    return v_;
+  } else {
+    typedef std::conditional_t<sizeof(T) == 2, uint16_t, std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>> bits_type;
+    static_assert(sizeof(T) == sizeof(bits_type), "tbyteswap supports 1, 2, 4 and 8 byte types");
+    bits_type bits = std::bit_cast<bits_type>(v_);
+    if constexpr (sizeof(T) == 2) {
+      bits = __builtin_bswap16(bits);
+    } else if constexpr (sizeof(T) == 4) {
+      bits = __builtin_bswap32(bits);
+    } else {
+      bits = __builtin_bswap64(bits);
+    }
+    return std::bit_cast<T>(bits);
+  }
+}
+
+template <typename NAME, size_t OFFSET, typename T, tendian ENDIAN = tendian::little>
+struct tfield
+{
+  static_assert(std::is_trivially_copyable_v<T>, "tfield types must be trivially copyable");
+
+  typedef NAME name;
+  typedef T value_type;
+
+  static constexpr size_t offset = OFFSET;
+  static constexpr size_t end = OFFSET + sizeof(T);
+  static constexpr tendian endian = ENDIAN;
+
+  // read this field from a message starting at msg_
+  static constexpr T load(const uint8_t *msg_) {
+    T v;
+    if(std::is_constant_evaluated()) {
+      std::array<uint8_t, sizeof(T)> bytes{};
+      for(size_t i = 0 ; i < sizeof(T) ; ++i) {
+	bytes[i] = msg_[OFFSET + i];
+      }
+      v = std::bit_cast<T>(bytes);
+    } else {
+      std::memcpy(&v, msg_ + OFFSET, sizeof(T));
+    }
+    constexpr bool host_little = std::endian::native == std::endian::little;
+    if constexpr ((ENDIAN == tendian::little) != host_little) {
+      v = tbyteswap(v);
+    }
+    return v;
+  }
+};
+
+template <typename... FIELDS>
+struct tschema
+{
+  typedef std::tuple<FIELDS...> fields;
+
+  // number of fields
+  static constexpr size_t size() { return sizeof...(FIELDS); }
+
+  // minimum message length covering every field
+  static constexpr size_t bytes() {
+    size_t n = 0;
+    for(size_t e : {FIELDS::end...}) {
+      n = e > n ? e : n;
+    }
+    return n;
+  }
+
+  // index of the field called NAME (a tstr)
+  template <typename NAME>
+    static constexpr size_t index_of() {
+    constexpr std::string_view names[] = {typename FIELDS::name{}()...};
+    for(size_t i = 0 ; i < size() ; ++i) {
+      if(names[i] == NAME()()) {
+	return i;
+      }
+    }
+    throw std::out_of_range("no such field in tschema");
+  }
+
+  template <typename NAME>
+    using field = std::tuple_element_t<index_of<NAME>(), fields>;
+
+  template <typename NAME>
+    static constexpr typename field<NAME>::value_type get(const uint8_t *msg_) { return field<NAME>::load(msg_); }
+
+  // a zero-copy view of one message
+  class view
+  {
+  public:
+    constexpr explicit view(std::span<const uint8_t> msg_) : _msg(msg_.data()) {
+      if(msg_.size() < bytes()) {
+	throw std::out_of_range("message too short for tschema");
+      }
+    }
+
+    template <typename NAME>
+      constexpr typename field<NAME>::value_type get() const { return field<NAME>::load(_msg); }
+
+    template <size_t I> requires (I < sizeof...(FIELDS))
+      constexpr auto get() const { return std::tuple_element_t<I, fields>::load(_msg); }
+
+  private:
+    const uint8_t *_msg;
+  };
+
+  // decode one field of n_ messages spaced stride_ bytes apart into a column
+  template <typename NAME>
+    static constexpr void decode_column(const uint8_t *msgs_, size_t n_, size_t stride_, typename field<NAME>::value_type *out_) {
+    for(size_t i = 0 ; i < n_ ; ++i) {
+      out_[i] = field<NAME>::load(msgs_ + i * stride_);
+    }
+  }
+
+  // decode every field of n_ messages into one column per field (structure of arrays),
+  // one field at a time so each pass is a simple strided loop
+  static constexpr void decode_all(const uint8_t *msgs_, size_t n_, size_t stride_, std::tuple<typename FIELDS::value_type *...> columns_) {
+    decode_all(msgs_, n_, stride_, columns_, std::make_index_sequence<size()>());
+  }
+
+private:
+  template <size_t... I>
+    static constexpr void decode_all(const uint8_t *msgs_, size_t n_, size_t stride_,
+				     std::tuple<typename FIELDS::value_type *...> columns_, std::index_sequence<I...>) {
+    ([&] {
+      for(size_t i = 0 ; i < n_ ; ++i) {
+	std::get<I>(columns_)[i] = std::tuple_element_t<I, fields>::load(msgs_ + i * stride_);
+      }
+    }(), ...);
+  }
+};
+
+#endif
@@ -0,0 +1,122 @@
+#ifndef __STATIC_EMA_H__
+#define __STATIC_EMA_H__
+
+#include <array>
+
+#include "static_types.h"
+
+// a bank of exponential moving averages, one per decay factor in a tlist
+// (for example tema<tlist<double, 0.9999, 0.998, 0.9333, 0.5>>)
+//
+// every horizon is updated as value = decay * value + (1 - decay) * sample --
+// the decays and their complements are frozen into constant arrays and the
+// horizons are stored contiguously, so one update is a single vectorizable pass
+//
+// with BIAS_CORRECT the bank starts from zero and reads are divided by (1 - decay^t),
+// which removes the pull towards zero during warm-up
+template <typename DECAYS, bool BIAS_CORRECT = false>
+class tema
+{
+public:
+  typedef typename DECAYS::value_type value_type;
+
+  static constexpr size_t size() { return DECAYS::size(); }
+
+  static_assert(size() > 0, "tema needs at least one decay");
+  static_assert([] {
+      for(size_t i = 0 ; i < size() ; ++i) {
+	if(!(DECAYS()[i] >= 0 && DECAYS()[i] < 1)) {
+	  return false;
+	}
+      }
+      return true;
+    }(), "tema decays must be in [0, 1)");
+
+  // initial_ is ignored when bias correcting (the bank must start from zero)
+  constexpr explicit tema(value_type initial_ = 0) { reset(initial_); }
+
+  constexpr void reset(value_type initial_ = 0) {
+    for(size_t i = 0 ; i < size() ; ++i) {
+      _values[i] = BIAS_CORRECT ? 0 : initial_;
+      _powers[i] = 1;
+    }
+  }
+
+  // fold one sample into every horizon
+  constexpr void update(value_type sample_) {
+    for(size_t i = 0 ; i < size() ; ++i) {
+      _values[i] = _decays[i] * _values[i] + _complements[i] * sample_;
+    }
+    if constexpr (BIAS_CORRECT) {
+      for(size_t i = 0 ; i < size() ; ++i) {
+	_powers[i] *= _decays[i];
+      }
+    }
+  }
+
+  // fold a block of samples for one instrument -- the bank is kept in locals
+  // for the duration of the block so it can stay in registers
+  constexpr void update_batch(const value_type *samples_, size_t n_) {
+    value_type values[size()];
+    for(size_t i = 0 ; i < size() ; ++i) {
+      values[i] = _values[i];
+    }
+    for(size_t s = 0 ; s < n_ ; ++s) {
+      for(size_t i = 0 ; i < size() ; ++i) {
+	values[i] = _decays[i] * values[i] + _complements[i] * samples_[s];
+      }
+    }
+    for(size_t i = 0 ; i < size() ; ++i) {
+      _values[i] = values[i];
+    }
+    if constexpr (BIAS_CORRECT) {
+      for(size_t s = 0 ; s < n_ ; ++s) {
+	for(size_t i = 0 ; i < size() ; ++i) {
+	  _powers[i] *= _decays[i];
+	}
+      }
+    }
+  }
+
+  // as above, but also write every (corrected) horizon after each sample to out_,
+  // which must hold n_ * size() values laid out sample by sample
+  constexpr void update_batch(const value_type *samples_, size_t n_, value_type *out_) {
+    for(size_t s = 0 ; s < n_ ; ++s) {
+      update(samples_[s]);
+      for(size_t i = 0 ; i < size() ; ++i) {
+	out_[s * size() + i] = (*this)[i];
+      }
+    }
+  }
+
+  // get the current value of the ith horizon
+  constexpr value_type operator[](size_t i_) const {
+    if constexpr (BIAS_CORRECT) {
+      return _powers[i_] == 1 ? 0 : _values[i_] / (1 - _powers[i_]);
+    } else {
+      return _values[i_];
+    }
+  }
+
+private:
+  static constexpr std::array<value_type, size()> _decays = [] {
+    std::array<value_type, size()> decays{};
+    for(size_t i = 0 ; i < size() ; ++i) {
+      decays[i] = DECAYS()[i];
+    }
+    return decays;
+  }();
+
+  static constexpr std::array<value_type, size()> _complements = [] {
+    std::array<value_type, size()> complements{};
+    for(size_t i = 0 ; i < size() ; ++i) {
+      complements[i] = 1 - DECAYS()[i];
+    }
+    return complements;
+  }();
+
+  value_type _values[size()];
+  value_type _powers[size()]; // decay^t per horizon, only used when bias correcting
+};
+
+#endif
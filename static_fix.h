@@ -0,0 +1,147 @@
+#ifndef __STATIC_FIX_H__
+#define __STATIC_FIX_H__
+
+#include <array>
+#include <bit>
+#include <string_view>
+
+#include "static_types.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// a tag=value (fix style) parser specialized on the tags we care about: values for the
+// wanted tags are routed into fixed slots, everything else is skipped without hashing
+// (for example tfix_parser<tlist<int, 35, 49, 56, 44, 38>>)
+//
+// tfix_parser<tlist<int, 35, 44, 38>> parser;
+// parser.parse(msg, len);
+// std::string_view px = parser.get<44>();
+//
+// the tag number is parsed from its digits and mapped to a slot through a dense table
+// (when the largest wanted tag is small) or a compare chain, and the end of each value
+// is found with an sse2 scan for the delimiter; values are views into the message
+template <typename TAGS, char DELIM = '\x01'>
+class tfix_parser
+{
+public:
+  static constexpr size_t size() { return TAGS::size(); }
+
+  static constexpr int max_tag() {
+    int max = 0;
+    for(size_t i = 0 ; i < size() ; ++i) {
+      max = TAGS()[i] > max ? TAGS()[i] : max;
+    }
+    return max;
+  }
+
+  static constexpr bool dense() { return max_tag() < 4096; }
+
+  // slot of a tag, or size() if we don't want it
+  static constexpr size_t slot_of(int tag_) {
+    if constexpr (dense()) {
+      return tag_ >= 0 && tag_ <= max_tag() ? _slots[tag_] : size();
+    } else {
+      for(size_t i = 0 ; i < size() ; ++i) {
+	if(TAGS()[i] == tag_) {
+	  return i;
+	}
+      }
+      return size();
+    }
+  }
+
+  // parse one message, replacing the values from any previous parse -- returns the
+  // number of wanted tags seen (a malformed field stops the parse)
+  constexpr size_t parse(const char *msg_, size_t n_) {
+    _values = {};
+    size_t found = 0;
+    size_t i = 0;
+    while(i < n_) {
+      // once the number is past the largest wanted tag it can only be unwanted, so it stops
+      // growing -- a long run of digits can't overflow into a wanted tag
+      int64_t tag = 0;
+      size_t start = i;
+      while(i < n_ && msg_[i] >= '0' && msg_[i] <= '9') {
+	tag = tag > max_tag() ? tag : tag * 10 + (msg_[i] - '0');
+	++i;
+      }
+      if(i == start || i == n_ || msg_[i] != '=') {
+	break;
+      }
+      ++i;
+      size_t end = find_delim(msg_, i, n_);
+      size_t slot = tag > max_tag() ? size() : slot_of(int(tag));
+      if(slot < size()) {
+	found += _values[slot].data() == nullptr;
+	_values[slot] = std::string_view(msg_ + i, end - i);
+      }
+      i = end + 1;
+    }
+    return found;
+  }
+
+  constexpr size_t parse(std::string_view msg_) { return parse(msg_.data(), msg_.size()); }
+
+  // value of a wanted tag (empty if the tag wasn't in the message)
+  template <int TAG>
+    constexpr std::string_view get() const {
+    constexpr size_t slot = slot_of(TAG);
+    static_assert(slot < size(), "tag isn't in the tfix_parser tag list");
+    return _values[slot];
+  }
+
+  template <int TAG>
+    constexpr bool has() const { return get<TAG>().data() != nullptr; }
+
+  constexpr std::string_view get(int tag_) const {
+    size_t slot = slot_of(tag_);
+    if(slot == size()) {
+      throw std::out_of_range("tag isn't in the tfix_parser tag list");
+    }
+    return _values[slot];
+  }
+
+private:
+  // position of the next delimiter at or after i_, or n_ if there isn't one
+  static constexpr size_t find_delim(const char *msg_, size_t i_, size_t n_) {
+#if defined(__SSE2__)
+    if(!std::is_constant_evaluated()) {
+      const __m128i delim = _mm_set1_epi8(DELIM);
+      for( ; i_ + 16 <= n_ ; i_ += 16) {
+	__m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(msg_ + i_));
+	int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, delim));
+	if(mask) {
+	  return i_ + std::countr_zero(unsigned(mask));
+	}
+      }
+    }
+#endif
+    while(i_ < n_ && msg_[i_] != DELIM) {
+      ++i_;
+    }
+    return i_;
+  }
+
+  static constexpr std::array<uint8_t, dense() ? max_tag() + 1 : 1> _slots = [] {
+    static_assert(size() < 255, "tfix_parser supports up to 254 tags");
+    std::array<uint8_t, dense() ? max_tag() + 1 : 1> slots{};
+    for(auto &s : slots) {
+      s = uint8_t(size());
+    }
+    if constexpr (dense()) {
+      for(size_t i = 0 ; i < size() ; ++i) {
+	if(TAGS()[i] < 0) {
+	  throw std::out_of_range("tfix_parser tags can't be negative");
+	}
+	slots[TAGS()[i]] = uint8_t(i);
+      }
+    }
+    return slots;
+  }();
+
+  std::array<std::string_view, size()> _values = {};
+};
+
+#endif
@@ -0,0 +1,261 @@
+#ifndef __STATIC_FREEZE_H__
+#define __STATIC_FREEZE_H__
+
+#include <array>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "static_types.h"
+#include "static_jagged.h"
+
+// build parameters with ordinary constexpr code (loops, std::vector, std::string) and
+// freeze the result into static storage: F is a constexpr lambda, run by the compiler,
+// and its result is copied into constant arrays sized from it
+//
+// constexpr auto ladder = [] {
+//   std::vector<double> v;
+//   for(int i = 0 ; i < 64 ; ++i) {
+//     v.push_back(1.0 / (1 << (i % 8)));
+//   }
+//   return v;
+// };
+// tfreeze_v<ladder>[3];         // a std::array<double, 64> -- no parameter pack at all
+// typedef tfreeze_t<ladder> l;  // the equivalent tlist<double, 1.0, 0.5, ...>
+//
+// tfreeze_t<F> maps F's result onto the existing static types:
+//   std::vector<number>                       -> tlist
+//   std::vector<std::string>                  -> tstrlist
+//   std::vector<std::vector<number or string>> -> tjagged
+//   std::string                               -> a tstr-like type
+//   std::vector<std::pair<key, value>>        -> tmap, where key is a number or a string and
+//                                                value a number, a string or a vector of either
+//
+// F is called a fixed number of times however long its result is (once for the shape and
+// once for the contents of each flattened array), and strings are stored once in one char
+// array, so large tables don't cost quadratic compile time
+
+// a std::array holding F's result (a vector or array of literal values)
+template <auto F>
+struct tfrozen_array
+{
+  typedef typename decltype(F())::value_type value_type;
+
+  static constexpr std::array<value_type, F().size()> value = [] {
+    std::array<value_type, F().size()> a{};
+    size_t i = 0;
+    for(const auto &v : F()) {
+      a[i++] = v;
+    }
+    return a;
+  }();
+};
+
+template <auto F>
+inline constexpr const auto &tfreeze_v = tfrozen_array<F>::value;
+
+// F's result (a vector of strings) concatenated into one char array, with offsets[i] the
+// start of the ith string
+template <auto F>
+struct tfrozen_strings
+{
+  static constexpr size_t count = F().size();
+
+  static constexpr std::array<size_t, count + 1> offsets = [] {
+    std::array<size_t, count + 1> offsets{};
+    size_t i = 0;
+    for(const auto &s : F()) {
+      offsets[i + 1] = offsets[i] + std::string_view(s).size();
+      ++i;
+    }
+    return offsets;
+  }();
+
+  static constexpr std::array<char, offsets[count]> chars = [] {
+    std::array<char, offsets[count]> chars{};
+    size_t n = 0;
+    for(const auto &s : F()) {
+      for(char c : std::string_view(s)) {
+	chars[n++] = c;
+      }
+    }
+    return chars;
+  }();
+
+  static constexpr std::string_view get(size_t i_) { return std::string_view(chars.data() + offsets[i_], offsets[i_ + 1] - offsets[i_]); }
+};
+
+// the Ith string of STRINGS as a tstr-like type (calling it gives the string_view)
+template <typename STRINGS, size_t I>
+struct tfrozen_str
+{
+  constexpr std::string_view operator()() const { return STRINGS::get(I); }
+};
+
+template <typename X>
+inline constexpr bool tfreeze_is_string = std::is_convertible_v<const X &, std::string_view> && !std::is_arithmetic_v<X>;
+
+// the elements [START, START + N) of F's result (numbers or strings) as a tlist or tstrlist
+template <auto F, size_t START, size_t N, typename = std::make_index_sequence<N>>
+struct tfrozen_range;
+
+template <auto F, size_t START, size_t N, size_t... J>
+struct tfrozen_range<F, START, N, std::index_sequence<J...>>
+{
+  typedef typename decltype(F())::value_type value_type;
+
+  static constexpr auto pick() {
+    if constexpr (tfreeze_is_string<value_type>) {
+      return std::type_identity<tstrlist<tfrozen_str<tfrozen_strings<F>, START + J>...>>();
+    } else {
+      return std::type_identity<tlist<value_type, tfrozen_array<F>::value[START + J]...>>();
+    }
+  }
+
+  typedef typename decltype(pick())::type type;
+};
+
+// F's result (a vector of vectors) flattened into one vector, with offsets[i] the start
+// of the ith inner vector
+template <auto F>
+struct tfrozen_rows
+{
+  typedef typename decltype(F())::value_type::value_type value_type;
+
+  static constexpr auto flat = [] {
+    std::vector<value_type> flat;
+    for(const auto &row : F()) {
+      for(const auto &v : row) {
+	flat.push_back(v);
+      }
+    }
+    return flat;
+  };
+
+  static constexpr std::array<size_t, F().size() + 1> offsets = [] {
+    std::array<size_t, F().size() + 1> offsets{};
+    size_t i = 0;
+    for(const auto &row : F()) {
+      offsets[i + 1] = offsets[i] + row.size();
+      ++i;
+    }
+    return offsets;
+  }();
+
+  template <size_t I>
+    using row = typename tfrozen_range<flat, offsets[I], offsets[I + 1] - offsets[I]>::type;
+};
+
+// the Ith element of F's result as a type: a tval for a number, a tfrozen_str for a
+// string, and a tlist or tstrlist for a vector
+template <auto F, size_t I>
+struct tfrozen_element
+{
+  typedef typename decltype(F())::value_type value_type;
+
+  static constexpr auto pick() {
+    if constexpr (std::is_arithmetic_v<value_type> || std::is_enum_v<value_type>) {
+      return std::type_identity<tval<tfrozen_array<F>::value[I]>>();
+    } else if constexpr (tfreeze_is_string<value_type>) {
+      return std::type_identity<tfrozen_str<tfrozen_strings<F>, I>>();
+    } else {
+      return std::type_identity<typename tfrozen_rows<F>::template row<I>>();
+    }
+  }
+
+  typedef typename decltype(pick())::type type;
+};
+
+// F's result (a vector of vectors) as a tjagged
+template <auto F, typename = std::make_index_sequence<F().size()>>
+struct tfrozen_jagged;
+
+template <auto F, size_t... I>
+struct tfrozen_jagged<F, std::index_sequence<I...>>
+{
+  typedef typename tfrozen_rows<F>::value_type element_type;
+  typedef std::conditional_t<tfreeze_is_string<element_type>, std::string_view, element_type> value_type;
+
+  typedef tjagged<value_type, typename tfrozen_rows<F>::template row<I>...> type;
+};
+
+// F's result (a vector of pairs) as a tmap -- the key and value types default to the
+// pair's, with strings looked up as std::string_view and lists by their element type
+template <auto F, typename = std::make_index_sequence<F().size()>>
+struct tfrozen_map;
+
+template <auto F, size_t... I>
+struct tfrozen_map<F, std::index_sequence<I...>>
+{
+  typedef typename decltype(F())::value_type pair_type;
+  typedef typename pair_type::first_type first_type;
+  typedef typename pair_type::second_type second_type;
+
+  static constexpr auto keys = [] {
+    std::vector<first_type> keys;
+    for(const auto &kv : F()) {
+      keys.push_back(kv.first);
+    }
+    return keys;
+  };
+
+  static constexpr auto values = [] {
+    std::vector<second_type> values;
+    for(const auto &kv : F()) {
+      values.push_back(kv.second);
+    }
+    return values;
+  };
+
+  template <typename X>
+    static constexpr auto lookup_type() {
+    if constexpr (tfreeze_is_string<X>) {
+      return std::type_identity<std::string_view>();
+    } else if constexpr (std::is_arithmetic_v<X> || std::is_enum_v<X>) {
+      return std::type_identity<X>();
+    } else {
+      return lookup_type<typename X::value_type>();
+    }
+  }
+
+  typedef typename decltype(lookup_type<first_type>())::type key_type;
+  typedef typename decltype(lookup_type<second_type>())::type value_type;
+
+  typedef tmap<key_type, value_type,
+	       std::pair<typename tfrozen_element<keys, I>::type, typename tfrozen_element<values, I>::type>...> type;
+};
+
+template <auto F>
+struct tfreeze
+{
+  typedef decltype(F()) result_type;
+
+  static constexpr auto pick() {
+    if constexpr (requires { typename result_type::value_type::first_type; }) {
+      return std::type_identity<typename tfrozen_map<F>::type>();
+    } else if constexpr (requires { typename result_type::value_type::value_type; } &&
+			 !tfreeze_is_string<typename result_type::value_type>) {
+      return std::type_identity<typename tfrozen_jagged<F>::type>();
+    } else {
+      return std::type_identity<typename tfrozen_range<F, 0, F().size()>::type>();
+    }
+  }
+
+  typedef typename decltype(pick())::type type;
+};
+
+// a single string stays a string rather than becoming a one-element tstrlist
+template <auto F> requires tfreeze_is_string<decltype(F())>
+struct tfreeze<F>
+{
+  static constexpr auto wrap = [] { return std::vector<std::string>{std::string(F())}; };
+
+  typedef tfrozen_str<tfrozen_strings<wrap>, 0> type;
+};
+
+template <auto F>
+using tfreeze_t = typename tfreeze<F>::type;
+
+#endif
@@ -0,0 +1,191 @@
+#ifndef __STATIC_FSM_H__
+#define __STATIC_FSM_H__
+
+#include <array>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "static_types.h"
+
+// a static finite-state machine built from a compile-time list of transitions
+//
+// enum class order_state { idle, pending, live, done };
+// enum class order_event { send, ack, fill, cancel };
+// tfsm<order_state::idle,
+//      ttransition<order_state::idle, order_event::send, order_state::pending>,
+//      ttransition<order_state::pending, order_event::ack, order_state::live, on_ack>,
+//      ttransition<order_state::live, order_event::fill, order_state::done>> fsm;
+// fsm.process(order_event::send);             // runtime event, returns false if rejected
+// fsm.process<order_state::pending, order_event::ack>(); // constant, checked at compile time
+//
+// states and events are enums (or integers) numbered from zero; each transition may carry
+// an action type, held by value and called with no arguments when the transition fires
+//
+// when at least a quarter of the state x event grid is populated the machine looks up the
+// next state in a dense table, otherwise it compiles to a compare chain (which the
+// compiler is free to turn into a nested switch) -- either way actions are called directly
+
+struct tno_action { constexpr void operator()() {} };
+
+template <auto FROM, auto EVENT, auto TO, typename ACTION = tno_action>
+struct ttransition
+{
+  static_assert(std::is_same_v<decltype(FROM), decltype(TO)>, "ttransition FROM and TO must be the same type");
+
+  typedef decltype(FROM) state_type;
+  typedef decltype(EVENT) event_type;
+  typedef ACTION action_type;
+
+  static constexpr state_type from = FROM;
+  static constexpr event_type event = EVENT;
+  static constexpr state_type to = TO;
+};
+
+template <auto INITIAL, typename... TRANSITIONS>
+class tfsm
+{
+public:
+  typedef decltype(INITIAL) state_type;
+  typedef std::tuple_element_t<0, std::tuple<typename TRANSITIONS::event_type...>> event_type;
+
+  static_assert((std::is_same_v<state_type, typename TRANSITIONS::state_type> && ...), "tfsm transitions must share a state type");
+  static_assert((std::is_same_v<event_type, typename TRANSITIONS::event_type> && ...), "tfsm transitions must share an event type");
+
+  static constexpr size_t size() { return sizeof...(TRANSITIONS); }
+
+  static constexpr size_t states() {
+    size_t n = size_t(INITIAL) + 1;
+    for(size_t s : {size_t(TRANSITIONS::from)..., size_t(TRANSITIONS::to)...}) {
+      n = s + 1 > n ? s + 1 : n;
+    }
+    return n;
+  }
+
+  static constexpr size_t events() {
+    size_t n = 0;
+    for(size_t e : {size_t(TRANSITIONS::event)...}) {
+      n = e + 1 > n ? e + 1 : n;
+    }
+    return n;
+  }
+
+  static constexpr bool dense() { return size() * 4 >= states() * events(); }
+
+  // is there a transition out of FROM on EVENT
+  static constexpr bool accepts(state_type from_, event_type event_) {
+    return ((TRANSITIONS::from == from_ && TRANSITIONS::event == event_) || ...);
+  }
+
+  static_assert([] {
+      size_t from[] = {size_t(TRANSITIONS::from)...};
+      size_t event[] = {size_t(TRANSITIONS::event)...};
+      for(size_t i = 0 ; i < size() ; ++i) {
+	for(size_t j = 0 ; j < i ; ++j) {
+	  if(from[i] == from[j] && event[i] == event[j]) {
+	    return false;
+	  }
+	}
+      }
+      return true;
+    }(), "tfsm has two transitions for the same state and event");
+
+  constexpr state_type state() const { return _state; }
+  constexpr void reset(state_type state_ = INITIAL) {
+    if(size_t(state_) >= states()) {
+      throw std::out_of_range("state out of range in tfsm::reset");
+    }
+    _state = state_;
+  }
+
+  // apply a runtime event, returning false (and staying put) if the current state
+  // has no transition for it, or either is out of range
+  constexpr bool process(event_type event_) {
+    if constexpr (dense()) {
+      size_t cell = size_t(_state) * events() + size_t(event_);
+      if(size_t(_state) >= states() || size_t(event_) >= events() || _table[cell] == 0) {
+	return false;
+      }
+      _state = _next[cell];
+      if constexpr (has_actions()) {
+	run_action(_table[cell] - 1, std::make_index_sequence<size()>());
+      }
+      return true;
+    } else {
+      return process_chain(event_, std::make_index_sequence<size()>());
+    }
+  }
+
+  // apply a constant event -- it is a compile error if no state accepts it
+  template <auto EVENT>
+    constexpr bool process() {
+    static_assert(((TRANSITIONS::event == EVENT) || ...), "no tfsm transition takes this event");
+    return process(EVENT);
+  }
+
+  // apply a constant event from a constant state -- it is a compile error if that
+  // transition doesn't exist, and a std::logic_error if the machine isn't in FROM
+  template <auto FROM, auto EVENT>
+    constexpr void process() {
+    static_assert(accepts(FROM, EVENT), "no tfsm transition for this state and event");
+    if(_state != FROM) {
+      throw std::logic_error("tfsm is not in the expected state");
+    }
+    process_chain(EVENT, std::make_index_sequence<size()>());
+  }
+
+  // apply n_ events in order, returning how many were rejected
+  constexpr size_t process_batch(const event_type *events_, size_t n_) {
+    size_t rejected = 0;
+    for(size_t i = 0 ; i < n_ ; ++i) {
+      rejected += !process(events_[i]);
+    }
+    return rejected;
+  }
+
+  // the action object of the ith transition
+  template <size_t I> requires (I < sizeof...(TRANSITIONS))
+    constexpr auto &action() { return std::get<I>(_actions); }
+
+private:
+  static constexpr bool has_actions() {
+    return (!std::is_same_v<typename TRANSITIONS::action_type, tno_action> || ...);
+  }
+
+  // 1 + index of the transition for each (state, event), or 0 for none
+  static constexpr std::array<uint16_t, states() * events()> _table = [] {
+    std::array<uint16_t, states() * events()> table{};
+    uint16_t i = 0;
+    ((table[size_t(TRANSITIONS::from) * events() + size_t(TRANSITIONS::event)] = ++i), ...);
+    return table;
+  }();
+
+  static constexpr std::array<state_type, states() * events()> _next = [] {
+    std::array<state_type, states() * events()> next{};
+    ((next[size_t(TRANSITIONS::from) * events() + size_t(TRANSITIONS::event)] = TRANSITIONS::to), ...);
+    return next;
+  }();
+
+  template <size_t... I>
+    constexpr void run_action(size_t transition_, std::index_sequence<I...>) {
+    ((transition_ == I && (std::get<I>(_actions)(), true)) || ...);
+  }
+
+  template <size_t... I>
+    constexpr bool process_chain(event_type event_, std::index_sequence<I...>) {
+    return ([&] {
+      typedef std::tuple_element_t<I, std::tuple<TRANSITIONS...>> transition;
+      if(_state == transition::from && event_ == transition::event) {
+	_state = transition::to;
+	std::get<I>(_actions)();
+	return true;
+      }
+      return false;
+    }() || ...);
+  }
+
+  state_type _state = INITIAL;
+  std::tuple<typename TRANSITIONS::action_type...> _actions;
+};
+
+#endif
@@ -0,0 +1,174 @@
+#ifndef __STATIC_INCREMENTAL_H__
+#define __STATIC_INCREMENTAL_H__
+
+#include <array>
+
+#include "static_types.h"
+
+// accumulators over runtime inputs with static coefficients that are kept up to date
+// incrementally: changing one input only touches the cells that depend on it, rather
+// than rebuilding the whole array the way calc2::update() does
+//
+// the dependency structure comes from the list sizes, so affected(j) is a constant and
+// the set<J>() forms have a fixed trip count the compiler can unroll
+//
+// note: repeated deltas accumulate rounding error -- call rebuild() now and then if
+// inputs change many times between reads that need to be exact
+
+// running weighted sums over inputs x: cell k holds sum(weights[i] * x[i], i <= k)
+// (for example tprefix_sum<tlist<double, 0.5, 0.25, 0.125>>)
+// changing input j only touches the suffix of cells [j, size())
+template <typename WEIGHTS>
+class tprefix_sum
+{
+public:
+  typedef typename WEIGHTS::value_type value_type;
+
+  static constexpr size_t size() { return WEIGHTS::size(); }
+
+  // number of cells that depend on input j_
+  static constexpr size_t affected(size_t j_) { return j_ < size() ? size() - j_ : 0; }
+
+  // change input j_, updating only the cells that depend on it -- returns how many
+  // (affected(j_)) were
+  constexpr size_t set(size_t j_, value_type x_) {
+    if(j_ >= size()) {
+      throw std::out_of_range("input out of range in tprefix_sum::set");
+    }
+    value_type delta = _weights[j_] * (x_ - _inputs[j_]);
+    _inputs[j_] = x_;
+    for(size_t k = j_ ; k < size() ; ++k) {
+      _values[k] += delta;
+    }
+    return size() - j_;
+  }
+
+  // as above, but with the input index (and so the suffix length) known at compile time
+  template <size_t J> requires (J < WEIGHTS::size())
+    constexpr size_t set(value_type x_) {
+    value_type delta = _weights[J] * (x_ - _inputs[J]);
+    _inputs[J] = x_;
+    for(size_t k = J ; k < size() ; ++k) {
+      _values[k] += delta;
+    }
+    return size() - J;
+  }
+
+  // recompute every cell from the inputs
+  constexpr void rebuild() {
+    value_type sum = 0;
+    for(size_t k = 0 ; k < size() ; ++k) {
+      sum += _weights[k] * _inputs[k];
+      _values[k] = sum;
+    }
+  }
+
+  constexpr value_type input(size_t j_) const { return _inputs[j_]; }
+  constexpr value_type operator[](size_t k_) const { return _values[k_]; }
+  constexpr value_type total() const { return _values[size() - 1]; }
+
+private:
+  static constexpr WEIGHTS _weights = {};
+
+  value_type _inputs[size()] = {};
+  value_type _values[size()] = {};
+};
+
+// an outer-product grid: cell (i, j) holds coefs[i] * ids[j] * x[j] for one runtime
+// input x per column, along with the sum over all cells
+// (for example touter_sum<tlist<double, 0.5, 0.25>, tlist<uint64_t, 1, 2>>)
+// changing input j only touches column j plus the total, O(rows) instead of O(rows * cols)
+// -- and only the rows with a nonzero coefficient, or nothing when column j's id is zero
+template <typename COEFS, typename IDS>
+class touter_sum
+{
+public:
+  typedef typename COEFS::value_type value_type;
+
+  static constexpr size_t rows() { return COEFS::size(); }
+  static constexpr size_t cols() { return IDS::size(); }
+  static constexpr size_t size() { return rows() * cols(); }
+
+  // number of cells that depend on input j_: the rows with a nonzero coefficient, or none
+  // when column j_'s id is zero
+  static constexpr size_t affected(size_t j_) { return j_ < cols() && _ids[j_] != 0 ? _nonzero_rows : 0; }
+
+  // change input j_, updating only the cells that depend on it -- returns how many
+  // (affected(j_)) were
+  constexpr size_t set(size_t j_, value_type x_) {
+    if(j_ >= cols()) {
+      throw std::out_of_range("input out of range in touter_sum::set");
+    }
+    return set_column(j_, x_);
+  }
+
+  template <size_t J> requires (J < IDS::size())
+    constexpr size_t set(value_type x_) {
+    return set_column(J, x_);
+  }
+
+  // recompute every cell from the inputs
+  constexpr void rebuild() {
+    _total = 0;
+    for(size_t i = 0 ; i < rows() ; ++i) {
+      for(size_t j = 0 ; j < cols() ; ++j) {
+	_values[i * cols() + j] = _coefs[i] * _ids[j] * _inputs[j];
+	_total += _values[i * cols() + j];
+      }
+    }
+  }
+
+  constexpr value_type input(size_t j_) const { return _inputs[j_]; }
+  constexpr value_type operator()(size_t i_, size_t j_) const { return _values[i_ * cols() + j_]; }
+  constexpr value_type total() const { return _total; }
+
+private:
+  constexpr size_t set_column(size_t j_, value_type x_) {
+    value_type delta = _ids[j_] * (x_ - _inputs[j_]);
+    _inputs[j_] = x_;
+    if(_ids[j_] == 0) {
+      return 0;
+    }
+    for(size_t i : _nonzero_row_list) {
+      _values[i * cols() + j_] += _coefs[i] * delta;
+    }
+    _total += _coef_sum * delta;
+    return _nonzero_rows;
+  }
+
+  static constexpr COEFS _coefs = {};
+  static constexpr IDS _ids = {};
+  static constexpr value_type _coef_sum = [] {
+    value_type sum = 0;
+    for(size_t i = 0 ; i < rows() ; ++i) {
+      sum += COEFS()[i];
+    }
+    return sum;
+  }();
+
+  static constexpr size_t _nonzero_rows = [] {
+    size_t n = 0;
+    for(size_t i = 0 ; i < rows() ; ++i) {
+      n += COEFS()[i] != 0;
+    }
+    return n;
+  }();
+
+  // the rows with a nonzero coefficient, the only ones an input change can reach
+  static constexpr std::array<size_t, _nonzero_rows> _nonzero_row_list = [] {
+    std::array<size_t, _nonzero_rows> list{};
+    size_t n = 0;
+    for(size_t i = 0 ; i < rows() ; ++i) {
+      if(COEFS()[i] != 0) {
+	list[n++] = i;
+      }
+    }
+    return list;
+  }();
+
+  value_type _inputs[cols()] = {};
+  value_type _values[size()] = {};
+  value_type _total = 0;
+};
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef __STATIC_JAGGED_H__
+#define __STATIC_JAGGED_H__
+
+#include <array>
+#include <span>
+#include <stdexcept>
+
+#include "static_types.h"
+
+// a static list of lists with different lengths (for example per-level ladders), stored
+// as one contiguous array plus a table of row offsets
+//
+// typedef tjagged<double, tlist<double, 0.5>,
+//                         tlist<double, 0.25, 0.5, 1.0>,
+//                         tlist<double, 2.0, 4.0>> ladders;
+// ladders()(1, 2);                   // 1.0 -- one add and one load
+// ladders::get<2, 0>();              // 2.0, checked and folded at compile time
+// for(double x : ladders::row(1)) {  // a std::span over the row, contiguous with the next
+//   ...
+// }
+//
+// rows may be tlists or tstrlists (T is then std::string_view), and may be empty
+template <typename T, typename... ROWS>
+struct tjagged
+{
+  typedef T value_type;
+
+  // number of rows
+  static constexpr size_t rows() { return sizeof...(ROWS); }
+
+  // number of elements over all rows
+  static constexpr size_t size() { return offsets[sizeof...(ROWS)]; }
+
+  // number of elements in row i_
+  static constexpr size_t size(size_t i_) { return offsets[i_ + 1] - offsets[i_]; }
+
+  // offsets[i] is the start of row i in values, and offsets[rows()] the end of the last
+  static constexpr std::array<size_t, sizeof...(ROWS) + 1> offsets = [] {
+    std::array<size_t, sizeof...(ROWS) + 1> offsets{};
+    size_t i = 0;
+    ((offsets[i + 1] = offsets[i] + ROWS::size(), ++i), ...);
+    return offsets;
+  }();
+
+  // every row's elements, one row after another
+  static constexpr std::array<T, offsets[sizeof...(ROWS)]> values = [] {
+    std::array<T, offsets[sizeof...(ROWS)]> values{};
+    size_t n = 0;
+    ([&] {
+      for(size_t j = 0 ; j < ROWS::size() ; ++j) {
+	values[n++] = ROWS()[j];
+      }
+    }(), ...);
+    return values;
+  }();
+
+  // element j_ of row i_ (unchecked)
+  constexpr T operator()(size_t i_, size_t j_) const { return values[offsets[i_] + j_]; }
+
+  // element j_ of row i_, throwing std::out_of_range if there isn't one
+  static constexpr T at(size_t i_, size_t j_) {
+    if(i_ >= rows() || j_ >= size(i_)) {
+      throw std::out_of_range("index out of range in tjagged");
+    }
+    return values[offsets[i_] + j_];
+  }
+
+  template <size_t I, size_t J> requires (I < sizeof...(ROWS))
+    static constexpr T get() {
+    static_assert(J < offsets[I + 1] - offsets[I], "column out of range in tjagged row");
+    return values[offsets[I] + J];
+  }
+
+  // row i_ as a view into values
+  static constexpr std::span<const T> row(size_t i_) { return std::span<const T>(values.data() + offsets[i_], size(i_)); }
+
+  // row I, with its length part of the type
+  template <size_t I> requires (I < sizeof...(ROWS))
+    static constexpr std::span<const T, offsets[I + 1] - offsets[I]> row() {
+    return std::span<const T, offsets[I + 1] - offsets[I]>(values.data() + offsets[I], offsets[I + 1] - offsets[I]);
+  }
+};
+
+#endif
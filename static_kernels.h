@@ -0,0 +1,159 @@
+#ifndef __STATIC_KERNELS_H__
+#define __STATIC_KERNELS_H__
+
+#include <array>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "static_types.h"
+
+// loops over the values of a tlist or tstrlist, expanded one of two ways depending on the
+// list's size:
+// - up to STATIC_TYPES_UNROLL_THRESHOLD values, a fold over the values -- fully unrolled,
+//   so each value is an immediate and the whole thing often folds down to a constant
+// - above it, a plain loop over the values in a static array, written with independent
+//   lane accumulators so the compiler vectorizes it instead of emitting (or giving up on)
+//   one huge unrolled block
+//
+// double y = tdot<coefs>(x);                           // sum of coefs[i] * x[i]
+// bool known = tcontains<tstrlist<...>>(name);
+// double total = tsum<ids>([&](uint64_t id) { return prices[id]; });
+// tfor_each<coefs>([&](double c) { ... });
+//
+// the second template argument forces one form or the other; the threshold itself can be
+// set per build variant (e.g. in CCFLAGS_debug / CCFLAGS_opt) -- note that floating point
+// results can differ in the last bits between the two forms, as the loop adds in lanes
+
+#ifndef STATIC_TYPES_UNROLL_THRESHOLD
+#define STATIC_TYPES_UNROLL_THRESHOLD 16
+#endif
+
+// does LIST get the unrolled expansion by default
+template <typename LIST>
+inline constexpr bool tunroll_v = LIST::size() <= STATIC_TYPES_UNROLL_THRESHOLD;
+
+// independent accumulators in the looped kernels, enough to fill an avx-512 register of doubles
+inline constexpr size_t tkernel_lanes = 8;
+
+// the values of a list as a static array
+template <typename LIST>
+struct tlist_values;
+
+template <typename T, T... ARGS>
+struct tlist_values<tlist<T, ARGS...>>
+{
+  typedef T value_type;
+  static constexpr std::array<T, sizeof...(ARGS)> values = {ARGS...};
+};
+
+template <typename... ARGS>
+struct tlist_values<tstrlist<ARGS...>>
+{
+  typedef std::string_view value_type;
+  static constexpr std::array<std::string_view, sizeof...(ARGS)> values = {std::string_view(ARGS()())...};
+};
+
+// call fn_ with each value in order
+template <typename LIST, bool UNROLL = tunroll_v<LIST>, typename FN>
+constexpr void tfor_each(FN &&fn_)
+{
+  constexpr const auto &values = tlist_values<LIST>::values;
+  if constexpr (UNROLL) {
+    [&]<size_t... I>(std::index_sequence<I...>) {
+      (fn_(values[I]), ...);
+    }(std::make_index_sequence<values.size()>());
+  } else {
+    for(const auto &v : values) {
+      fn_(v);
+    }
+  }
+}
+
+// sum of fn_(value) over the values
+template <typename LIST, bool UNROLL = tunroll_v<LIST>, typename FN>
+constexpr auto tsum(FN &&fn_)
+{
+  constexpr const auto &values = tlist_values<LIST>::values;
+  typedef std::remove_cvref_t<decltype(fn_(values[0]))> result_type;
+  if constexpr (UNROLL) {
+    return [&]<size_t... I>(std::index_sequence<I...>) {
+      return (result_type() + ... + fn_(values[I]));
+    }(std::make_index_sequence<values.size()>());
+  } else {
+    result_type acc[tkernel_lanes] = {};
+    size_t i = 0;
+    for( ; i + tkernel_lanes <= values.size() ; i += tkernel_lanes) {
+      for(size_t j = 0 ; j < tkernel_lanes ; ++j) {
+	acc[j] += fn_(values[i + j]);
+      }
+    }
+    for( ; i < values.size() ; ++i) {
+      acc[i % tkernel_lanes] += fn_(values[i]);
+    }
+    for(size_t width = tkernel_lanes / 2 ; width > 0 ; width /= 2) {
+      for(size_t j = 0 ; j < width ; ++j) {
+	acc[j] += acc[j + width];
+      }
+    }
+    return acc[0];
+  }
+}
+
+// sum of values[i] * x_[i], x_ holding LIST::size() values
+template <typename LIST, bool UNROLL = tunroll_v<LIST>, typename X>
+constexpr auto tdot(const X *x_)
+{
+  constexpr const auto &values = tlist_values<LIST>::values;
+  typedef decltype(values[0] * x_[0]) result_type;
+  if constexpr (UNROLL) {
+    return [&]<size_t... I>(std::index_sequence<I...>) {
+      return (result_type() + ... + (values[I] * x_[I]));
+    }(std::make_index_sequence<values.size()>());
+  } else {
+    result_type acc[tkernel_lanes] = {};
+    size_t i = 0;
+    for( ; i + tkernel_lanes <= values.size() ; i += tkernel_lanes) {
+      for(size_t j = 0 ; j < tkernel_lanes ; ++j) {
+	acc[j] += values[i + j] * x_[i + j];
+      }
+    }
+    for( ; i < values.size() ; ++i) {
+      acc[i % tkernel_lanes] += values[i] * x_[i];
+    }
+    for(size_t width = tkernel_lanes / 2 ; width > 0 ; width /= 2) {
+      for(size_t j = 0 ; j < width ; ++j) {
+	acc[j] += acc[j + width];
+      }
+    }
+    return acc[0];
+  }
+}
+
+// is v_ one of the values -- the loop compares against every value without branching,
+// except for strings, where it stops at the first match
+template <typename LIST, bool UNROLL = tunroll_v<LIST>, typename V>
+constexpr bool tcontains(const V &v_)
+{
+  constexpr const auto &values = tlist_values<LIST>::values;
+  if constexpr (UNROLL) {
+    return [&]<size_t... I>(std::index_sequence<I...>) {
+      return ((values[I] == v_) || ...);
+    }(std::make_index_sequence<values.size()>());
+  } else if constexpr (std::is_same_v<typename tlist_values<LIST>::value_type, std::string_view>) {
+    for(std::string_view v : values) {
+      if(v == v_) {
+	return true;
+      }
+    }
+    return false;
+  } else {
+    unsigned found = 0;
+    for(const auto &v : values) {
+      found |= unsigned(v == v_);
+    }
+    return found != 0;
+  }
+}
+
+#endif
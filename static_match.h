@@ -0,0 +1,214 @@
+#ifndef __STATIC_MATCH_H__
+#define __STATIC_MATCH_H__
+
+#include <array>
+#include <bit>
+#include <string_view>
+
+#include "static_types.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// a multi-pattern matcher over a fixed tstrlist: the aho-corasick automaton is built at
+// compile time into constant tables (so it lives in .rodata, shared by every process)
+//
+// typedef tmatcher<tstrlist<tstr("ESZ4"), tstr("NQZ4"), tstr("CLF5")>> blocked;
+// blocked::stream scan;
+// scan.find_all(buf, len, [](size_t pattern_, size_t end_) { ... });
+//
+// the automaton is stored as a full transition table (every failure link already followed),
+// so matching is one table load per byte; while the automaton is at the root, bytes that
+// can't start any pattern are skipped -- with sse2 sixteen at a time when the patterns
+// start with at most four distinct bytes, otherwise through a lookup table
+//
+// at most 64 patterns are supported (matches are reported from a 64-bit mask per state)
+template <typename PATTERNS>
+struct tmatcher
+{
+  static constexpr size_t size() { return PATTERNS::size(); }
+
+  static_assert(size() > 0 && size() <= 64, "tmatcher supports 1 to 64 patterns");
+  static_assert([] {
+      for(size_t p = 0 ; p < size() ; ++p) {
+	if(PATTERNS()[p].empty()) {
+	  return false;
+	}
+      }
+      return true;
+    }(), "tmatcher patterns can't be empty");
+
+  // number of automaton states (trie nodes, including the root)
+  static constexpr size_t states() {
+    // walk the trie without storing it: a prefix adds a node unless an earlier
+    // pattern shares it
+    size_t n = 1;
+    for(size_t p = 0 ; p < size() ; ++p) {
+      std::string_view s = PATTERNS()[p];
+      for(size_t len = 1 ; len <= s.size() ; ++len) {
+	bool seen = false;
+	for(size_t q = 0 ; q < p && !seen ; ++q) {
+	  seen = PATTERNS()[q].substr(0, len) == s.substr(0, len);
+	}
+	n += !seen;
+      }
+    }
+    return n;
+  }
+
+  static_assert(states() < 65536, "tmatcher automaton too large");
+
+  struct tables {
+    std::array<uint16_t, states() * 256> next;  // full transition table, state * 256 + byte
+    std::array<uint64_t, states()> matches;     // patterns ending at each state
+    std::array<bool, 256> starts;               // bytes that leave the root
+    std::array<uint8_t, 4> start_bytes;         // the distinct first bytes, if there are at most four
+    size_t start_count;
+  };
+
+  static constexpr tables automaton = [] {
+    tables t{};
+    constexpr uint16_t none = 0xffff;
+    for(auto &n : t.next) {
+      n = none;
+    }
+    // trie
+    uint16_t count = 1;
+    for(size_t p = 0 ; p < size() ; ++p) {
+      uint16_t s = 0;
+      for(char c : PATTERNS()[p]) {
+	uint16_t &n = t.next[s * 256 + uint8_t(c)];
+	if(n == none) {
+	  n = count++;
+	}
+	s = n;
+      }
+      t.matches[s] |= uint64_t(1) << p;
+    }
+    // breadth-first over the trie, filling in failure transitions as we go
+    std::array<uint16_t, states()> fail{};
+    std::array<uint16_t, states()> queue{};
+    size_t head = 0;
+    size_t tail = 0;
+    for(size_t c = 0 ; c < 256 ; ++c) {
+      uint16_t &n = t.next[c];
+      if(n == none) {
+	n = 0;
+      } else {
+	t.starts[c] = true;
+	fail[n] = 0;
+	queue[tail++] = n;
+      }
+    }
+    while(head < tail) {
+      uint16_t s = queue[head++];
+      t.matches[s] |= t.matches[fail[s]];
+      for(size_t c = 0 ; c < 256 ; ++c) {
+	uint16_t &n = t.next[s * 256 + c];
+	if(n == none) {
+	  n = t.next[fail[s] * 256 + c];
+	} else {
+	  fail[n] = t.next[fail[s] * 256 + c];
+	  queue[tail++] = n;
+	}
+      }
+    }
+    for(size_t c = 0 ; c < 256 ; ++c) {
+      if(t.starts[c]) {
+	if(t.start_count < t.start_bytes.size()) {
+	  t.start_bytes[t.start_count] = uint8_t(c);
+	}
+	++t.start_count;
+      }
+    }
+    return t;
+  }();
+
+  // length of the pth pattern
+  static constexpr size_t pattern_size(size_t p_) { return PATTERNS()[p_].size(); }
+
+  // a scan in progress -- the automaton state carries over between buffers, so a
+  // match may straddle two calls to find_all
+  class stream
+  {
+  public:
+    // call found_(pattern, end) for every match ending in data_[0, n_), where end is the
+    // offset one past the match's last byte in this buffer; returns the number of matches
+    template <typename FOUND>
+      constexpr size_t find_all(const char *data_, size_t n_, FOUND found_) {
+      size_t count = 0;
+      uint16_t s = _state;
+      for(size_t i = 0 ; i < n_ ; ) {
+	if(s == 0) {
+	  i = skip(data_, i, n_);
+	  if(i == n_) {
+	    break;
+	  }
+	}
+	s = automaton.next[s * 256 + uint8_t(data_[i++])];
+	for(uint64_t m = automaton.matches[s] ; m ; m &= m - 1) {
+	  found_(size_t(std::countr_zero(m)), i);
+	  ++count;
+	}
+      }
+      _state = s;
+      return count;
+    }
+
+    constexpr size_t find_all(std::string_view data_) {
+      return find_all(data_.data(), data_.size(), [](size_t, size_t) {});
+    }
+
+    constexpr void reset() { _state = 0; }
+
+  private:
+    uint16_t _state = 0;
+  };
+
+  // does any pattern occur in data_
+  static constexpr bool contains_any(std::string_view data_) {
+    uint16_t s = 0;
+    for(size_t i = 0 ; i < data_.size() ; ) {
+      if(s == 0) {
+	i = skip(data_.data(), i, data_.size());
+	if(i == data_.size()) {
+	  break;
+	}
+      }
+      s = automaton.next[s * 256 + uint8_t(data_[i++])];
+      if(automaton.matches[s]) {
+	return true;
+      }
+    }
+    return false;
+  }
+
+private:
+  // first position at or after i_ holding a byte that can start a pattern
+  static constexpr size_t skip(const char *data_, size_t i_, size_t n_) {
+#if defined(__SSE2__)
+    if(!std::is_constant_evaluated() && automaton.start_count <= automaton.start_bytes.size()) {
+      __m128i bytes[4];
+      for(size_t b = 0 ; b < 4 ; ++b) {
+	bytes[b] = _mm_set1_epi8(char(automaton.start_bytes[b < automaton.start_count ? b : 0]));
+      }
+      for( ; i_ + 16 <= n_ ; i_ += 16) {
+	__m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data_ + i_));
+	__m128i hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, bytes[0]), _mm_cmpeq_epi8(chunk, bytes[1])),
+				   _mm_or_si128(_mm_cmpeq_epi8(chunk, bytes[2]), _mm_cmpeq_epi8(chunk, bytes[3])));
+	int mask = _mm_movemask_epi8(hit);
+	if(mask) {
+	  return i_ + std::countr_zero(unsigned(mask));
+	}
+      }
+    }
+#endif
+    while(i_ < n_ && !automaton.starts[uint8_t(data_[i_])]) {
+      ++i_;
+    }
+    return i_;
+  }
+};
+
+#endif
@@ -0,0 +1,172 @@
+#ifndef __STATIC_MLP_H__
+#define __STATIC_MLP_H__
+
+#include <array>
+#include <cmath>
+#include <utility>
+
+#include "static_types.h"
+
+// small multi-layer perceptrons with frozen weights, for scoring nets that are
+// latency critical and small enough (say, 64 wide or less) to be baked into the code
+//
+// each layer fuses matvec + bias + activation; since every weight is a constant the
+// compiler can drop zeros, turn the rest into immediates and unroll everything:
+//
+// typedef tlayer<2, 2, tlist<double, 1.0, 0.0, 0.5, -1.0>, tlist<double, 0.0, 0.1>, trelu> hidden;
+// typedef tlayer<2, 1, tlist<double, 1.0, 2.0>, tlist<double, 0.0>, tidentity> output;
+// tmlp<hidden, output> net;
+// double score;
+// net.eval(features, &score);
+
+struct tidentity { static constexpr double apply(double x_) { return x_; } };
+struct trelu { static constexpr double apply(double x_) { return x_ > 0 ? x_ : 0; } };
+struct tsigmoid { static double apply(double x_) { return 1 / (1 + std::exp(-x_)); } };
+struct ttanh { static double apply(double x_) { return std::tanh(x_); } };
+
+// a fully connected layer: out[o] = ACTIVATION(bias[o] + sum(weights[o * IN + i] * in[i]))
+// (WEIGHTS is row-major with one row per output)
+//
+// sparse layers (at most half the weights nonzero) are emitted as a fully unrolled list
+// of multiply-adds over the nonzero weights only; denser layers keep every weight, stored
+// input-major so that the per-output dot products vectorize across outputs
+template <size_t IN, size_t OUT, typename WEIGHTS, typename BIASES, typename ACTIVATION = trelu>
+struct tlayer
+{
+  static_assert(WEIGHTS::size() == IN * OUT, "tlayer needs IN * OUT weights");
+  static_assert(BIASES::size() == OUT, "tlayer needs OUT biases");
+
+  static constexpr size_t in_size() { return IN; }
+  static constexpr size_t out_size() { return OUT; }
+
+  // number of weights left after pruning zeros
+  static constexpr size_t nonzeros() {
+    size_t n = 0;
+    for(size_t k = 0 ; k < IN * OUT ; ++k) {
+      n += WEIGHTS()[k] != 0;
+    }
+    return n;
+  }
+
+  static constexpr bool sparse() { return nonzeros() * 2 <= IN * OUT; }
+
+  static constexpr void eval(const double *in_, double *out_) {
+    double sums[OUT];
+    for(size_t o = 0 ; o < OUT ; ++o) {
+      sums[o] = _biases[o];
+    }
+    if constexpr (sparse()) {
+      accumulate_sparse(in_, sums, std::make_index_sequence<nonzeros()>());
+    } else {
+      for(size_t o = 0 ; o < OUT ; ++o) {
+	double sum = sums[o];
+	for(size_t i = 0 ; i < IN ; ++i) {
+	  sum += _dense[i * OUT + o] * in_[i];
+	}
+	sums[o] = sum;
+      }
+    }
+    for(size_t o = 0 ; o < OUT ; ++o) {
+      out_[o] = ACTIVATION::apply(sums[o]);
+    }
+  }
+
+private:
+  struct tterm {
+    size_t in;
+    size_t out;
+    double weight;
+  };
+
+  template <size_t... K>
+    static constexpr void accumulate_sparse(const double *in_, double *sums_, std::index_sequence<K...>) {
+    ((sums_[_terms[K].out] += _terms[K].weight * in_[_terms[K].in]), ...);
+  }
+
+  static constexpr BIASES _biases = {};
+
+  // weights transposed to input-major, so neighbouring outputs are contiguous
+  static constexpr std::array<double, IN * OUT> _dense = [] {
+    std::array<double, IN * OUT> dense{};
+    for(size_t o = 0 ; o < OUT ; ++o) {
+      for(size_t i = 0 ; i < IN ; ++i) {
+	dense[i * OUT + o] = WEIGHTS()[o * IN + i];
+      }
+    }
+    return dense;
+  }();
+
+  // the nonzero weights only
+  static constexpr std::array<tterm, nonzeros()> _terms = [] {
+    std::array<tterm, nonzeros()> terms{};
+    size_t n = 0;
+    for(size_t o = 0 ; o < OUT ; ++o) {
+      for(size_t i = 0 ; i < IN ; ++i) {
+	if(WEIGHTS()[o * IN + i] != 0) {
+	  terms[n++] = {i, o, WEIGHTS()[o * IN + i]};
+	}
+      }
+    }
+    return terms;
+  }();
+};
+
+// a chain of tlayers, each feeding the next
+template <typename... LAYERS>
+struct tmlp
+{
+  static_assert(sizeof...(LAYERS) > 0, "tmlp needs at least one layer");
+
+  typedef std::tuple<LAYERS...> layers;
+
+  static constexpr size_t size() { return sizeof...(LAYERS); }
+  static constexpr size_t in_size() { return std::tuple_element_t<0, layers>::in_size(); }
+  static constexpr size_t out_size() { return std::tuple_element_t<size() - 1, layers>::out_size(); }
+
+  static_assert([] {
+      size_t ins[] = {LAYERS::in_size()...};
+      size_t outs[] = {LAYERS::out_size()...};
+      for(size_t l = 1 ; l < size() ; ++l) {
+	if(ins[l] != outs[l - 1]) {
+	  return false;
+	}
+      }
+      return true;
+    }(), "tmlp layer shapes don't chain");
+
+  // score one sample: in_ holds in_size() features, out_ receives out_size() values
+  static constexpr void eval(const double *in_, double *out_) {
+    double buffers[2][width()];
+    eval_layer<0>(in_, out_, buffers);
+  }
+
+  // score n_ samples stored back to back
+  static constexpr void eval_batch(const double *in_, size_t n_, double *out_) {
+    for(size_t s = 0 ; s < n_ ; ++s) {
+      eval(in_ + s * in_size(), out_ + s * out_size());
+    }
+  }
+
+private:
+  static constexpr size_t width() {
+    size_t w = 0;
+    for(size_t n : {LAYERS::out_size()...}) {
+      w = n > w ? n : w;
+    }
+    return w;
+  }
+
+  // ping-pong between two scratch buffers, with the last layer writing straight to out_
+  template <size_t L>
+    static constexpr void eval_layer(const double *in_, double *out_, double (&buffers_)[2][width()]) {
+    typedef std::tuple_element_t<L, layers> layer;
+    if constexpr (L + 1 == size()) {
+      layer::eval(in_, out_);
+    } else {
+      layer::eval(in_, buffers_[L % 2]);
+      eval_layer<L + 1>(buffers_[L % 2], out_, buffers_);
+    }
+  }
+};
+
+#endif
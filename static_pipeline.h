@@ -0,0 +1,184 @@
+#ifndef __STATIC_PIPELINE_H__
+#define __STATIC_PIPELINE_H__
+
+#include <array>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "static_types.h"
+
+// a static dataflow pipeline: each stage declares the stages it reads from as a type,
+// and the pipeline works out a valid evaluation order at compile time
+//
+// a stage is any default-constructible class with an inputs typedef and an update()
+// taking one argument per input, in the order they are listed:
+//
+// struct mid_price {
+//   typedef tinputs<best_bid, best_ask> inputs;
+//   double update(double bid_, double ask_) { return (bid_ + ask_) / 2; }
+// };
+// tpipeline<mid_price, best_bid, best_ask> pipe; // stages can be listed in any order
+// pipe.update();
+// double mid = pipe.get<mid_price>();
+//
+// stages are grouped into levels (a stage's level is one more than the deepest of its
+// inputs); update() runs the levels in order as straight-line code the compiler can
+// inline and fuse, while the stages within one level are independent and can be handed
+// to an executor to run in parallel
+
+template <typename... STAGES>
+struct tinputs {};
+
+template <typename... STAGES>
+struct tpipeline
+{
+  // stages are looked up by type, so a repeated one would silently resolve to the first
+  static_assert(thlist<STAGES...>::distinct() == sizeof...(STAGES), "tpipeline stages must be distinct");
+
+  static constexpr size_t size() { return sizeof...(STAGES); }
+
+  template <typename STAGE>
+    static constexpr size_t index_of() {
+    constexpr bool matches[] = {std::is_same_v<STAGE, STAGES>...};
+    for(size_t i = 0 ; i < size() ; ++i) {
+      if(matches[i]) {
+	return i;
+      }
+    }
+    return size();
+  }
+
+private:
+  template <typename STAGE, typename INPUTS = typename STAGE::inputs>
+    struct stage_traits;
+
+  template <typename STAGE, typename... INPUTS>
+    struct stage_traits<STAGE, tinputs<INPUTS...>> {
+    static_assert(((index_of<INPUTS>() < size()) && ...), "tpipeline stage reads from a stage that isn't in the pipeline");
+
+    typedef decltype(std::declval<STAGE &>().update(std::declval<typename stage_traits<INPUTS>::result_type>()...)) result_type;
+
+    static constexpr std::array<size_t, sizeof...(INPUTS)> inputs = {index_of<INPUTS>()...};
+  };
+
+  // levels[i] is the level of the ith stage, found by relaxing the input edges --
+  // if that hasn't settled after size() rounds there is a cycle
+  static constexpr std::array<size_t, size()> levels = [] {
+    std::array<size_t, size()> levels{};
+    bool changed = true;
+    for(size_t round = 0 ; changed ; ++round) {
+      if(round > size()) {
+	throw std::logic_error("cycle in tpipeline stages");
+      }
+      changed = false;
+      size_t i = 0;
+      ([&] {
+	for(size_t in : stage_traits<STAGES>::inputs) {
+	  if(levels[i] < levels[in] + 1) {
+	    levels[i] = levels[in] + 1;
+	    changed = true;
+	  }
+	}
+	++i;
+      }(), ...);
+    }
+    return levels;
+  }();
+
+  // stage indices sorted by level (stable, so ties keep their listed order)
+  static constexpr std::array<size_t, size()> order = [] {
+    std::array<size_t, size()> order{};
+    size_t n = 0;
+    for(size_t level = 0 ; n < size() ; ++level) {
+      for(size_t i = 0 ; i < size() ; ++i) {
+	if(levels[i] == level) {
+	  order[n++] = i;
+	}
+      }
+    }
+    return order;
+  }();
+
+public:
+  // number of levels, and the number of stages / position in order of the first stage in a level
+  static constexpr size_t level_count() { return size() ? levels[order[size() - 1]] + 1 : 0; }
+
+  static constexpr size_t level_size(size_t level_) {
+    size_t n = 0;
+    for(size_t l : levels) {
+      n += l == level_;
+    }
+    return n;
+  }
+
+  static constexpr size_t level_start(size_t level_) {
+    size_t n = 0;
+    for(size_t l : levels) {
+      n += l < level_;
+    }
+    return n;
+  }
+
+  // level of a stage, 0 for stages with no inputs
+  template <typename STAGE>
+    static constexpr size_t level_of() { return levels[index_of<STAGE>()]; }
+
+  // run every stage once, in dependency order
+  constexpr void update() {
+    run_order(std::make_index_sequence<size()>());
+  }
+
+  // run every stage once, level by level: for each level exec_ is called with one
+  // callable per stage in that level, which it may run concurrently but must all have
+  // completed before it returns (e.g. exec_ = [](auto&&... fns) { ...fork/join... })
+  template <typename EXECUTOR>
+    void update(EXECUTOR &&exec_) {
+    if constexpr (size() > 0) {
+      run_levels<0>(exec_);
+    }
+  }
+
+  // the most recent output of a stage
+  template <typename STAGE>
+    constexpr const auto &get() const { return std::get<index_of<STAGE>()>(_outputs); }
+
+  // the stage object itself
+  template <typename STAGE>
+    constexpr STAGE &stage() { return std::get<index_of<STAGE>()>(_stages); }
+
+private:
+  template <size_t I>
+    constexpr void run_stage() {
+    typedef std::tuple_element_t<I, std::tuple<STAGES...>> stage_type;
+    run_stage<I>(typename stage_type::inputs());
+  }
+
+  template <size_t I, typename... INPUTS>
+    constexpr void run_stage(tinputs<INPUTS...>) {
+    std::get<I>(_outputs) = std::get<I>(_stages).update(std::get<index_of<INPUTS>()>(_outputs)...);
+  }
+
+  template <size_t... I>
+    constexpr void run_order(std::index_sequence<I...>) {
+    (run_stage<order[I]>(), ...);
+  }
+
+  template <size_t L, typename EXECUTOR>
+    void run_levels(EXECUTOR &exec_) {
+    run_level<L>(exec_, std::make_index_sequence<level_size(L)>());
+    if constexpr (L + 1 < level_count()) {
+      run_levels<L + 1>(exec_);
+    }
+  }
+
+  template <size_t L, typename EXECUTOR, size_t... I>
+    void run_level(EXECUTOR &exec_, std::index_sequence<I...>) {
+    exec_([this] { run_stage<order[level_start(L) + I]>(); }...);
+  }
+
+  std::tuple<STAGES...> _stages;
+  std::tuple<typename stage_traits<STAGES>::result_type...> _outputs;
+};
+
+#endif
@@ -0,0 +1,111 @@
+#ifndef __STATIC_POLY_H__
+#define __STATIC_POLY_H__
+
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "static_types.h"
+
+// a runtime number of objects whose types come from a closed list, stored by type: one
+// contiguous vector per type instead of a vector of pointers to a common base
+//
+// tpoly<calc_a, calc_b, calc_c> models;
+// models.emplace<calc_b>(...);
+// models.insert(calc_a(...));
+// models.visit([&](auto &m) { sum += m.update(); });  // every calc_a, then every calc_b, ...
+//
+// a visit is one loop per type over contiguous objects calling the concrete update --
+// no virtual calls and no pointer chasing, and the call is inlined into the loop -- at
+// the cost of objects being visited grouped by type rather than in insertion order;
+// erase() moves the type's last object into the hole, so order within a type isn't
+// kept either
+template <typename... TYPES>
+class tpoly
+{
+public:
+  static_assert(thlist<TYPES...>::distinct() == sizeof...(TYPES), "tpoly types must be distinct");
+
+  // can the collection hold a T
+  template <typename T>
+  static constexpr bool holds() { return (std::is_same_v<T, TYPES> || ...); }
+
+  // number of objects (of every type, or of type T)
+  constexpr size_t size() const { return (std::get<std::vector<TYPES>>(_segments).size() + ...); }
+
+  template <typename T> requires (holds<T>())
+  constexpr size_t size() const { return segment<T>().size(); }
+
+  constexpr bool empty() const { return size() == 0; }
+
+  constexpr void clear() { (std::get<std::vector<TYPES>>(_segments).clear(), ...); }
+
+  template <typename T> requires (holds<T>())
+  constexpr void reserve(size_t n_) { std::get<std::vector<T>>(_segments).reserve(n_); }
+
+  template <typename T, typename... ARGS> requires (holds<T>())
+  constexpr T &emplace(ARGS &&... args_) { return std::get<std::vector<T>>(_segments).emplace_back(std::forward<ARGS>(args_)...); }
+
+  template <typename T> requires (holds<std::remove_cvref_t<T>>())
+  constexpr std::remove_cvref_t<T> &insert(T &&v_) { return emplace<std::remove_cvref_t<T>>(std::forward<T>(v_)); }
+
+  // remove the i_th object of type T, moving the last one of that type into its place
+  template <typename T> requires (holds<T>())
+  constexpr void erase(size_t i_) {
+    std::vector<T> &v = std::get<std::vector<T>>(_segments);
+    if(i_ + 1 != v.size()) {
+      v[i_] = std::move(v.back());
+    }
+    v.pop_back();
+  }
+
+  // the objects of type T
+  template <typename T> requires (holds<T>())
+  constexpr std::span<T> segment() { return std::get<std::vector<T>>(_segments); }
+
+  template <typename T> requires (holds<T>())
+  constexpr std::span<const T> segment() const { return std::get<std::vector<T>>(_segments); }
+
+  // call visitor_ on every object, type by type in the order of TYPES
+  template <typename VISITOR>
+  constexpr void visit(VISITOR visitor_) { (visit_segment<TYPES>(visitor_), ...); }
+
+  template <typename VISITOR>
+  constexpr void visit(VISITOR visitor_) const { (visit_segment<TYPES>(visitor_), ...); }
+
+  // call visitor_ on the objects of type T
+  template <typename T, typename VISITOR> requires (holds<T>())
+  constexpr void visit_each(VISITOR visitor_) { visit_segment<T>(visitor_); }
+
+  // call visitor_ on the objects whose type satisfies PRED (a trait, as for thlist) --
+  // the other types' loops aren't generated at all
+  template <template <typename> typename PRED, typename VISITOR>
+  constexpr void visit_if(VISITOR visitor_) {
+    ([&] {
+      if constexpr (bool(PRED<TYPES>::value)) {
+	visit_segment<TYPES>(visitor_);
+      }
+    }(), ...);
+  }
+
+private:
+  template <typename T, typename VISITOR>
+  constexpr void visit_segment(VISITOR &visitor_) {
+    for(T &v : std::get<std::vector<T>>(_segments)) {
+      visitor_(v);
+    }
+  }
+
+  template <typename T, typename VISITOR>
+  constexpr void visit_segment(VISITOR &visitor_) const {
+    for(const T &v : std::get<std::vector<T>>(_segments)) {
+      visitor_(v);
+    }
+  }
+
+  std::tuple<std::vector<TYPES>...> _segments;
+};
+
+#endif
@@ -0,0 +1,143 @@
+#ifndef __STATIC_QUANT_H__
+#define __STATIC_QUANT_H__
+
+#include <array>
+#include <type_traits>
+
+#include "static_types.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// quantized static lists: a tlist of doubles is converted at compile time into int8 or
+// int16 values plus one scale, so that value[i] ~= scale() * q[i]
+// (for example tqlist<tlist<double, 0.5, -0.25, 0.125>, int8_t, 0.002>)
+//
+// MAX_ERROR, when not negative, bounds the worst-case absolute reconstruction error
+// and is checked with a static_assert
+//
+// dot() takes activations quantized the same way (see tquantize) and returns the raw
+// integer dot product:
+// - int8 weights pair with uint8 activations, which maps onto vpdpbusd (vnni) or
+//   vpmaddubsw (avx2) -- note vpmaddubsw saturates adjacent pairs at int16, so on a plain
+//   avx2 build keep activations in [0, 127] to stay exact
+// - int16 weights pair with int16 activations, which maps onto vpmaddwd (avx2)
+// without avx2 (or at compile time) a scalar loop is used; sums accumulate in int32
+template <typename LIST, typename QTYPE = int8_t, double MAX_ERROR = -1.0>
+struct tqlist
+{
+  static_assert(std::is_same_v<QTYPE, int8_t> || std::is_same_v<QTYPE, int16_t>,
+		"tqlist only quantizes to int8_t or int16_t");
+
+  typedef QTYPE value_type;
+  // the activation type dot() expects
+  typedef std::conditional_t<std::is_same_v<QTYPE, int8_t>, uint8_t, int16_t> input_type;
+
+  static constexpr size_t size() { return LIST::size(); }
+
+  static constexpr double scale() {
+    double max = 0;
+    for(size_t i = 0 ; i < size() ; ++i) {
+      double v = LIST()[i] < 0 ? -LIST()[i] : LIST()[i];
+      max = v > max ? v : max;
+    }
+    return max == 0 ? 1.0 : max / qmax;
+  }
+
+  static constexpr std::array<QTYPE, size()> values = [] {
+    std::array<QTYPE, size()> q{};
+    for(size_t i = 0 ; i < size() ; ++i) {
+      double v = LIST()[i] / scale();
+      q[i] = QTYPE(v < 0 ? v - 0.5 : v + 0.5);
+    }
+    return q;
+  }();
+
+  // worst-case absolute error between the original list and scale() * values
+  static constexpr double max_error() {
+    double max = 0;
+    for(size_t i = 0 ; i < size() ; ++i) {
+      double e = LIST()[i] - scale() * values[i];
+      e = e < 0 ? -e : e;
+      max = e > max ? e : max;
+    }
+    return max;
+  }
+
+  static_assert(MAX_ERROR < 0 || max_error() <= MAX_ERROR, "tqlist quantization error exceeds MAX_ERROR");
+
+  // get the dequantized ith value
+  constexpr double operator[](size_t i_) const { return scale() * values[i_]; }
+
+  // integer dot product of the quantized values with size() activations
+  static constexpr int32_t dot(const input_type *x_) {
+    size_t i = 0;
+    int32_t sum = 0;
+#if defined(__AVX2__)
+    if(!std::is_constant_evaluated()) {
+      sum = dot_avx2(x_);
+      i = size() - size() % lanes;
+    }
+#endif
+    for( ; i < size() ; ++i) {
+      sum += int32_t(values[i]) * int32_t(x_[i]);
+    }
+    return sum;
+  }
+
+  // dot product in real units, given the scale the activations were quantized with
+  static constexpr double dot(const input_type *x_, double x_scale_) {
+    return scale() * x_scale_ * dot(x_);
+  }
+
+private:
+  static constexpr double qmax = std::is_same_v<QTYPE, int8_t> ? 127.0 : 32767.0;
+
+#if defined(__AVX2__)
+  static constexpr size_t lanes = 32 / sizeof(QTYPE);
+
+  // full 256-bit blocks only, the caller finishes the tail
+  static int32_t dot_avx2(const input_type *x_) {
+    __m256i acc = _mm256_setzero_si256();
+    for(size_t i = 0 ; i + lanes <= size() ; i += lanes) {
+      __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values.data() + i));
+      __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(x_ + i));
+      if constexpr (std::is_same_v<QTYPE, int8_t>) {
+#if defined(__AVX512VNNI__) && defined(__AVX512VL__)
+	acc = _mm256_dpbusd_epi32(acc, x, w);
+#elif defined(__AVXVNNI__)
+	acc = _mm256_dpbusd_avx_epi32(acc, x, w);
+#else
+	acc = _mm256_add_epi32(acc, _mm256_madd_epi16(_mm256_maddubs_epi16(x, w), _mm256_set1_epi16(1)));
+#endif
+      } else {
+	acc = _mm256_add_epi32(acc, _mm256_madd_epi16(x, w));
+      }
+    }
+    __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(sum);
+  }
+#endif
+};
+
+// quantize n_ activations with the given scale (x ~= scale_ * out), clamping to the
+// range of the output type -- for uint8 activations negative values clamp to zero
+template <typename T>
+constexpr void tquantize(const double *x_, size_t n_, double scale_, T *out_)
+{
+  static_assert(std::is_same_v<T, uint8_t> || std::is_same_v<T, int8_t> || std::is_same_v<T, int16_t>,
+		"tquantize only produces uint8_t, int8_t or int16_t");
+  constexpr double lo = std::is_same_v<T, uint8_t> ? 0.0 : std::is_same_v<T, int8_t> ? -128.0 : -32768.0;
+  constexpr double hi = std::is_same_v<T, uint8_t> ? 255.0 : std::is_same_v<T, int8_t> ? 127.0 : 32767.0;
+  for(size_t i = 0 ; i < n_ ; ++i) {
+    double v = x_[i] / scale_;
+    v = v < 0 ? v - 0.5 : v + 0.5;
+    v = v < lo ? lo : v > hi ? hi : v;
+    out_[i] = T(v);
+  }
+}
+
+#endif
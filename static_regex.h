@@ -0,0 +1,349 @@
+#ifndef __STATIC_REGEX_H__
+#define __STATIC_REGEX_H__
+
+#include <array>
+#include <bit>
+#include <string_view>
+
+#include "static_types.h"
+
+// compile-time regex and glob patterns: a pattern given as a tstr is parsed and turned
+// into a dfa at compile time, so matching is a table-driven loop with one load per byte
+//
+// tglob<tstr("ES*")>::match("ESZ4");                       // true
+// tregex<tstr("(ES|NQ)[HMUZ][0-9]")>::match("NQH5");        // true
+// tglobset<tstrlist<tstr("ES*"), tstr("*Z4")>>::match("ESZ4"); // 0b11, one bit per pattern
+//
+// matching is anchored at both ends (the whole string must match), as with globs
+//
+// supported regex syntax: literals, ., [...] / [^...] with ranges, \ escapes, (...)
+// groups, | alternation and the * + ? quantifiers
+// supported glob syntax: * (any run), ? (any byte), [...] / [!...] and \ escapes
+//
+// patterns are compiled glushkov style (one position per character or class) and every
+// pattern in a set shares one dfa, so a set costs the same per byte as a single pattern;
+// a set may hold at most 63 positions in total, and a malformed pattern is a compile error
+
+enum class tpattern_syntax { regex, glob };
+
+// the position automaton shared by every pattern in a set
+struct tpattern_nfa
+{
+  static constexpr size_t max_positions = 63;
+  static constexpr size_t start = 63;            // pseudo-position for "nothing read yet"
+
+  std::array<std::array<uint64_t, 4>, max_positions> classes{}; // bytes each position accepts
+  std::array<uint64_t, 64> follow{};             // positions that may come after each position
+  std::array<uint64_t, 64> last{};               // per pattern, positions that can end it
+  uint64_t nullable = 0;                         // per pattern, does it match ""
+  size_t positions = 0;
+};
+
+// first/last position sets of a sub-pattern
+struct tpattern_frag
+{
+  uint64_t first = 0;
+  uint64_t last = 0;
+  bool nullable = true;
+};
+
+// recursive descent over one pattern, adding its positions to an nfa
+class tpattern_parser
+{
+public:
+  constexpr tpattern_parser(std::string_view s_, tpattern_syntax syntax_, tpattern_nfa &nfa_)
+    : _s(s_), _syntax(syntax_), _nfa(nfa_) {}
+
+  constexpr tpattern_frag parse() {
+    tpattern_frag f = alternation();
+    if(_i != _s.size()) {
+      throw std::invalid_argument("unbalanced ) in pattern");
+    }
+    return f;
+  }
+
+private:
+  constexpr bool regex() const { return _syntax == tpattern_syntax::regex; }
+
+  constexpr tpattern_frag alternation() {
+    tpattern_frag f = concatenation();
+    while(regex() && _i < _s.size() && _s[_i] == '|') {
+      ++_i;
+      tpattern_frag g = concatenation();
+      f = {f.first | g.first, f.last | g.last, f.nullable || g.nullable};
+    }
+    return f;
+  }
+
+  constexpr tpattern_frag concatenation() {
+    tpattern_frag f;
+    while(_i < _s.size() && !(regex() && (_s[_i] == '|' || _s[_i] == ')'))) {
+      tpattern_frag g = repetition();
+      link(f.last, g.first);
+      f = {f.first | (f.nullable ? g.first : 0), g.last | (g.nullable ? f.last : 0), f.nullable && g.nullable};
+    }
+    return f;
+  }
+
+  constexpr tpattern_frag repetition() {
+    tpattern_frag f = atom();
+    while(regex() && _i < _s.size() && (_s[_i] == '*' || _s[_i] == '+' || _s[_i] == '?')) {
+      char q = _s[_i++];
+      if(q != '?') {
+	link(f.last, f.first);
+      }
+      if(q != '+') {
+	f.nullable = true;
+      }
+    }
+    return f;
+  }
+
+  constexpr tpattern_frag atom() {
+    char c = _s[_i++];
+    bool any_run = !regex() && c == '*';
+    std::array<uint64_t, 4> cls{};
+    if(regex() && c == '(') {
+      tpattern_frag f = alternation();
+      if(_i == _s.size() || _s[_i] != ')') {
+	throw std::invalid_argument("missing ) in pattern");
+      }
+      ++_i;
+      return f;
+    } else if(regex() && (c == '*' || c == '+' || c == '?')) {
+      throw std::invalid_argument("quantifier with nothing to repeat in pattern");
+    } else if(c == '[') {
+      cls = bracket();
+    } else if((regex() && c == '.') || (!regex() && (c == '?' || c == '*'))) {
+      cls = {~uint64_t(0), ~uint64_t(0), ~uint64_t(0), ~uint64_t(0)};
+    } else {
+      if(c == '\\') {
+	if(_i == _s.size()) {
+	  throw std::invalid_argument("trailing \\ in pattern");
+	}
+	c = _s[_i++];
+      }
+      add(cls, uint8_t(c));
+    }
+    tpattern_frag f = position(cls);
+    if(any_run) {
+      link(f.last, f.first);
+      f.nullable = true;
+    }
+    return f;
+  }
+
+  // a [...] class, with the opening [ already consumed
+  constexpr std::array<uint64_t, 4> bracket() {
+    std::array<uint64_t, 4> cls{};
+    bool negate = _i < _s.size() && _s[_i] == (regex() ? '^' : '!');
+    _i += negate;
+    bool first = true;
+    while(true) {
+      if(_i == _s.size()) {
+	throw std::invalid_argument("missing ] in pattern");
+      }
+      char c = _s[_i++];
+      if(c == ']' && !first) {
+	break;
+      }
+      first = false;
+      if(c == '\\' && _i < _s.size()) {
+	c = _s[_i++];
+      }
+      char hi = c;
+      if(_i + 1 < _s.size() && _s[_i] == '-' && _s[_i + 1] != ']') {
+	hi = _s[_i + 1];
+	_i += 2;
+      }
+      for(int b = uint8_t(c) ; b <= uint8_t(hi) ; ++b) {
+	add(cls, uint8_t(b));
+      }
+    }
+    if(negate) {
+      for(auto &w : cls) {
+	w = ~w;
+      }
+    }
+    return cls;
+  }
+
+  static constexpr void add(std::array<uint64_t, 4> &cls_, uint8_t b_) { cls_[b_ / 64] |= uint64_t(1) << (b_ % 64); }
+
+  constexpr tpattern_frag position(const std::array<uint64_t, 4> &cls_) {
+    if(_nfa.positions == tpattern_nfa::max_positions) {
+      throw std::length_error("too many positions in pattern set");
+    }
+    size_t p = _nfa.positions++;
+    _nfa.classes[p] = cls_;
+    return {uint64_t(1) << p, uint64_t(1) << p, false};
+  }
+
+  // every position in from_ may be followed by every position in to_
+  constexpr void link(uint64_t from_, uint64_t to_) {
+    for( ; from_ ; from_ &= from_ - 1) {
+      _nfa.follow[std::countr_zero(from_)] |= to_;
+    }
+  }
+
+  std::string_view _s;
+  tpattern_syntax _syntax;
+  tpattern_nfa &_nfa;
+  size_t _i = 0;
+};
+
+// a set of patterns compiled into one dfa -- match() returns a mask with bit k set if
+// pattern k matches the whole string
+template <tpattern_syntax SYNTAX, typename PATTERNS>
+struct tpatternset
+{
+  static constexpr size_t size() { return PATTERNS::size(); }
+
+  static_assert(size() > 0 && size() <= 64, "tpatternset supports 1 to 64 patterns");
+
+  static constexpr tpattern_nfa nfa = [] {
+    tpattern_nfa nfa{};
+    for(size_t k = 0 ; k < size() ; ++k) {
+      tpattern_frag f = tpattern_parser(PATTERNS()[k], SYNTAX, nfa).parse();
+      nfa.follow[tpattern_nfa::start] |= f.first;
+      nfa.last[k] = f.last;
+      nfa.nullable |= uint64_t(f.nullable) << k;
+    }
+    return nfa;
+  }();
+
+  // positions accepting a byte -- bytes with the same signature behave identically
+  static constexpr uint64_t signature(size_t b_) {
+    uint64_t sig = 0;
+    for(size_t p = 0 ; p < nfa.positions ; ++p) {
+      sig |= ((nfa.classes[p][b_ / 64] >> (b_ % 64)) & 1) << p;
+    }
+    return sig;
+  }
+
+  struct tshape {
+    size_t states;
+    size_t classes;
+  };
+
+  // worklist subset construction; state 0 is dead and state 1 is the start
+  template <size_t MAX>
+    struct tsubsets {
+    std::array<uint64_t, MAX> sets{};
+    std::array<uint64_t, 256> signatures{};
+    std::array<uint8_t, 256> byte_class{};
+    size_t states = 2;
+    size_t classes = 0;
+
+    constexpr size_t find_or_add(uint64_t set_) {
+      for(size_t s = 0 ; s < states ; ++s) {
+	if(sets[s] == set_) {
+	  return s;
+	}
+      }
+      if(states == MAX) {
+	throw std::length_error("pattern set dfa has too many states");
+      }
+      sets[states] = set_;
+      return states++;
+    }
+
+    constexpr void build() {
+      for(size_t b = 0 ; b < 256 ; ++b) {
+	uint64_t sig = signature(b);
+	size_t k = 0;
+	while(k < classes && signatures[k] != sig) {
+	  ++k;
+	}
+	if(k == classes) {
+	  signatures[classes++] = sig;
+	}
+	byte_class[b] = uint8_t(k);
+      }
+      sets[1] = uint64_t(1) << tpattern_nfa::start;
+      for(size_t s = 1 ; s < states ; ++s) {
+	uint64_t follow = 0;
+	for(uint64_t m = sets[s] ; m ; m &= m - 1) {
+	  follow |= nfa.follow[std::countr_zero(m)];
+	}
+	for(size_t k = 0 ; k < classes ; ++k) {
+	  find_or_add(follow & signatures[k]);
+	}
+      }
+    }
+  };
+
+  static constexpr size_t max_states = 4096;
+
+  static constexpr tshape shape = [] {
+    tsubsets<max_states> subsets;
+    subsets.build();
+    return tshape{subsets.states, subsets.classes};
+  }();
+
+  struct tdfa {
+    std::array<uint8_t, 256> byte_class;
+    std::array<uint16_t, shape.states * shape.classes> next;
+    std::array<uint64_t, shape.states> accept;
+  };
+
+  static constexpr tdfa dfa = [] {
+    tsubsets<shape.states> subsets;
+    subsets.build();
+    tdfa dfa{};
+    dfa.byte_class = subsets.byte_class;
+    for(size_t s = 1 ; s < shape.states ; ++s) {
+      uint64_t follow = 0;
+      for(uint64_t m = subsets.sets[s] ; m ; m &= m - 1) {
+	follow |= nfa.follow[std::countr_zero(m)];
+      }
+      for(size_t k = 0 ; k < shape.classes ; ++k) {
+	dfa.next[s * shape.classes + k] = uint16_t(subsets.find_or_add(follow & subsets.signatures[k]));
+      }
+      for(size_t p = 0 ; p < size() ; ++p) {
+	bool accepts = (subsets.sets[s] & nfa.last[p]) || (s == 1 && ((nfa.nullable >> p) & 1));
+	dfa.accept[s] |= uint64_t(accepts) << p;
+      }
+    }
+    return dfa;
+  }();
+
+  static_assert(shape.states < 65536, "pattern set dfa has too many states");
+
+  static constexpr uint64_t match(std::string_view s_) {
+    size_t state = 1;
+    for(char c : s_) {
+      state = dfa.next[state * shape.classes + dfa.byte_class[uint8_t(c)]];
+      if(state == 0) {
+	return 0;
+      }
+    }
+    return dfa.accept[state];
+  }
+
+  // does any pattern match
+  static constexpr bool any(std::string_view s_) { return match(s_) != 0; }
+};
+
+template <typename PATTERNS>
+using tregexset = tpatternset<tpattern_syntax::regex, PATTERNS>;
+
+template <typename PATTERNS>
+using tglobset = tpatternset<tpattern_syntax::glob, PATTERNS>;
+
+// a single compiled pattern
+template <tpattern_syntax SYNTAX, typename PATTERN>
+struct tpattern
+{
+  typedef tpatternset<SYNTAX, tstrlist<PATTERN>> set_type;
+
+  static constexpr bool match(std::string_view s_) { return set_type::any(s_); }
+};
+
+template <typename PATTERN>
+using tregex = tpattern<tpattern_syntax::regex, PATTERN>;
+
+template <typename PATTERN>
+using tglob = tpattern<tpattern_syntax::glob, PATTERN>;
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef __STATIC_SCRATCH_H__
+#define __STATIC_SCRATCH_H__
+
+#include <array>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "static_types.h"
+
+// keeping per-call working memory out of static-param objects, so that one object (the
+// frozen parameters) can be shared by any number of threads: the class declares the
+// scratch it needs as a scratch_type sized at compile time and takes it in a const update
+//
+// template <typename COEFS, typename IDS>
+// class calc2 {
+// public:
+//   typedef tscratch<double, COEFS::size() * IDS::size()> scratch_type;
+//   double update(scratch_type &scratch_) const;   // reentrant
+// };
+//
+// the caller decides where the scratch lives:
+// tupdate(model);                     // on the stack, for the duration of the call
+// tupdate_thread_local(model);        // one per thread and scratch type, reused across calls
+// tscratch_set<calc_a, calc_b> mine;  // or owned by the worker, one block for all its models
+// a.update(mine.get<calc_a>());
+
+// fixed-size working memory -- left uninitialized, like a local array would be
+template <typename T, size_t N>
+using tscratch = std::array<T, N>;
+
+// does T take its working memory as a scratch_type argument
+template <typename T>
+concept tuses_scratch = requires { typename T::scratch_type; };
+
+// empty stand-in for types that don't use scratch
+struct tno_scratch {};
+
+template <typename T>
+struct tscratch_of { typedef tno_scratch type; };
+
+template <tuses_scratch T>
+struct tscratch_of<T> { typedef typename T::scratch_type type; };
+
+template <typename T>
+using tscratch_t = typename tscratch_of<T>::type;
+
+// T's update called with scratch_ when it uses scratch, without it otherwise
+template <typename T, typename SCRATCH, typename... ARGS>
+constexpr decltype(auto) tupdate_with(const T &obj_, SCRATCH &scratch_, ARGS &&... args_)
+{
+  if constexpr (tuses_scratch<T>) {
+    return obj_.update(scratch_, std::forward<ARGS>(args_)...);
+  } else {
+    return obj_.update(std::forward<ARGS>(args_)...);
+  }
+}
+
+// update with scratch on the caller's stack
+template <typename T, typename... ARGS>
+constexpr decltype(auto) tupdate(const T &obj_, ARGS &&... args_)
+{
+  tscratch_t<T> scratch;
+  return tupdate_with(obj_, scratch, std::forward<ARGS>(args_)...);
+}
+
+// this thread's instance of SCRATCH -- TAG separates users that could be active at the
+// same time on one thread (e.g. an update calling another object's update of the same type)
+template <typename SCRATCH, typename TAG = void>
+SCRATCH &tthread_scratch()
+{
+  static thread_local SCRATCH scratch;
+  return scratch;
+}
+
+// update with this thread's scratch for T, for scratch too large for the stack
+template <typename T, typename... ARGS>
+decltype(auto) tupdate_thread_local(const T &obj_, ARGS &&... args_)
+{
+  return tupdate_with(obj_, tthread_scratch<tscratch_t<T>, T>(), std::forward<ARGS>(args_)...);
+}
+
+// one block holding the scratch of each of TYPES, for a worker sharing those objects
+template <typename... TYPES>
+struct tscratch_set
+{
+  std::tuple<tscratch_t<TYPES>...> items;
+
+  template <typename T>
+  constexpr tscratch_t<T> &get() { return std::get<thlist<TYPES...>::template index_of<T>()>(items); }
+
+  // update obj_ (of one of TYPES) with its scratch from this block
+  template <typename T, typename... ARGS>
+  constexpr decltype(auto) update(const T &obj_, ARGS &&... args_) { return tupdate_with(obj_, get<T>(), std::forward<ARGS>(args_)...); }
+};
+
+#endif
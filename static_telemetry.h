@@ -0,0 +1,308 @@
+#ifndef __STATIC_TELEMETRY_H__
+#define __STATIC_TELEMETRY_H__
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "static_types.h"
+#include "static_freeze.h"
+
+// always-on instrumentation without shared atomics on the hot path: every thread writes
+// its own cache-line isolated counters and histograms, and a reader (for example a
+// taggregator running in the background) sums them up while the writers keep going
+//
+// typedef tcounters<tstrlist<tstr("updates"), tstr("rejects")>> model_counters;
+// typedef thistogram<thdr_bounds<3, 1ull << 36>> latency_histogram;     // ns, ~12% resolution
+// tper_thread<model_counters>::local().add<tstr("updates")>();
+// tper_thread<latency_histogram>::local().record(ns);
+//
+// taggregator report(std::chrono::seconds(1), [] {
+//   auto counts = tper_thread<model_counters>::collect();
+//   auto latency = tper_thread<latency_histogram>::collect();
+//   printf("%lu updates, p99 %lu ns\n", counts[0], latency.quantile(0.99));
+// });
+//
+// cells are std::atomic only so that reading them from another thread is defined: the
+// owning thread updates them with a relaxed load and store (plain movs on x86, no lock
+// prefix), and a reader sees each cell's latest value without stopping anyone
+
+// a slot of T per thread, leased on the thread's first use and handed back when the thread
+// exits -- with its counts, which the next thread to lease it keeps adding to, so nothing
+// is lost and a pool that churns threads reuses the same few slots; TAG separates
+// independent uses of the same T
+//
+// the first MAX_THREADS slots are inline; when more threads than that are alive at once,
+// the extra ones get heap-allocated slots (kept, and reused, for the life of the process)
+template <typename T, typename TAG = void, size_t MAX_THREADS = 256>
+class tper_thread
+{
+public:
+  // this thread's T
+  static T &local() {
+    static thread_local tlease lease;
+    return lease.slot->value;
+  }
+
+  // number of slots handed out so far (at most the most threads ever alive at once)
+  static size_t threads() {
+    size_t n = _claimed.load(std::memory_order_acquire);
+    for(const tslot *s = _extra.load(std::memory_order_acquire) ; s ; s = s->next) {
+      ++n;
+    }
+    return n;
+  }
+
+  // call fn_ on every slot
+  template <typename FN>
+  static void for_each(FN fn_) {
+    size_t n = _claimed.load(std::memory_order_acquire);
+    for(size_t i = 0 ; i < n ; ++i) {
+      fn_(static_cast<const T &>(_slots[i].value));
+    }
+    for(const tslot *s = _extra.load(std::memory_order_acquire) ; s ; s = s->next) {
+      fn_(static_cast<const T &>(s->value));
+    }
+  }
+
+  // every thread's values merged into one T::snapshot_type
+  static typename T::snapshot_type collect() {
+    typename T::snapshot_type snapshot{};
+    for_each([&snapshot](const T &t_) { t_.merge_into(snapshot); });
+    return snapshot;
+  }
+
+private:
+  struct alignas(64) tslot {
+    T value;
+    tslot *next = nullptr;  // in the list of heap-allocated slots
+  };
+
+  // the slot a thread holds until it exits
+  struct tlease {
+    tslot *slot = claim();
+    ~tlease() { release(slot); }
+  };
+
+  // the free list, an inline slot or a new one -- the mutex also orders a returned slot's
+  // last updates before its next owner's first
+  static tslot *claim() {
+    std::lock_guard lock(_mutex);
+    if(!_free.empty()) {
+      tslot *s = _free.back();
+      _free.pop_back();
+      return s;
+    }
+    size_t i = _claimed.load(std::memory_order_relaxed);
+    if(i < MAX_THREADS) {
+      _claimed.store(i + 1, std::memory_order_release);
+      return &_slots[i];
+    }
+    tslot *s = new tslot{};
+    s->next = _extra.load(std::memory_order_relaxed);
+    _extra.store(s, std::memory_order_release);
+    return s;
+  }
+
+  static void release(tslot *s_) {
+    std::lock_guard lock(_mutex);
+    _free.push_back(s_);
+  }
+
+  static inline std::array<tslot, MAX_THREADS> _slots{};
+  static inline std::atomic<size_t> _claimed{0};
+  static inline std::atomic<tslot *> _extra{nullptr};
+  static inline std::mutex _mutex;
+  static inline std::vector<tslot *> _free;
+};
+
+// add to a cell only this thread writes
+inline void tbump(std::atomic<uint64_t> &cell_, uint64_t n_)
+{
+  cell_.store(cell_.load(std::memory_order_relaxed) + n_, std::memory_order_relaxed);
+}
+
+// named counters, the name resolved to a slot at compile time
+template <typename NAMES>
+class tcounters
+{
+public:
+  typedef std::array<uint64_t, NAMES::size()> snapshot_type;
+
+  static constexpr size_t size() { return NAMES::size(); }
+
+  template <typename NAME>
+  static constexpr size_t index_of() {
+    for(size_t i = 0 ; i < NAMES::size() ; ++i) {
+      if(NAMES()[i] == NAME()()) {
+	return i;
+      }
+    }
+    throw std::out_of_range("no such counter in tcounters");
+  }
+
+  template <typename NAME>
+  void add(uint64_t n_ = 1) {
+    constexpr size_t i = index_of<NAME>();
+    tbump(_cells[i], n_);
+  }
+
+  void add(size_t i_, uint64_t n_) { tbump(_cells[i_], n_); }
+
+  uint64_t get(size_t i_) const { return _cells[i_].load(std::memory_order_relaxed); }
+
+  void merge_into(snapshot_type &snapshot_) const {
+    for(size_t i = 0 ; i < NAMES::size() ; ++i) {
+      snapshot_[i] += get(i);
+    }
+  }
+
+private:
+  std::array<std::atomic<uint64_t>, NAMES::size()> _cells{};
+};
+
+// log-linear (hdr style) bucket bounds up to MAX: every value up to 2^SUB_BITS, then each
+// power of two split into 2^SUB_BITS equal buckets, so a value's bucket is within a
+// factor 1 + 2^-SUB_BITS of it
+template <size_t SUB_BITS, uint64_t MAX>
+struct thdr_layout
+{
+  static_assert(SUB_BITS < 16 && MAX > 0, "thdr_layout needs SUB_BITS < 16 and MAX > 0");
+
+  static constexpr auto bounds = [] {
+    std::vector<uint64_t> bounds;
+    for(uint64_t b = 1 ; b <= (uint64_t(1) << SUB_BITS) ; ++b) {
+      bounds.push_back(b);
+    }
+    for(size_t octave = SUB_BITS ; octave < 63 && bounds.back() < MAX ; ++octave) {
+      uint64_t step = uint64_t(1) << (octave - SUB_BITS);
+      for(uint64_t b = (uint64_t(1) << octave) + step ; b <= (uint64_t(2) << octave) ; b += step) {
+	bounds.push_back(b);
+      }
+    }
+    return bounds;
+  };
+
+  typedef tfreeze_t<bounds> type;
+};
+
+template <size_t SUB_BITS, uint64_t MAX>
+using thdr_bounds = typename thdr_layout<SUB_BITS, MAX>::type;
+
+// a histogram over the inclusive upper bounds in BOUNDS (an ascending tlist), plus an
+// overflow bucket -- record() finds the bucket from the value's top bit and a short scan
+// over the bounds sharing it, with no log() and no search over the whole list
+template <typename BOUNDS>
+class thistogram
+{
+public:
+  static constexpr size_t buckets() { return BOUNDS::size() + 1; }
+
+  static constexpr std::array<uint64_t, BOUNDS::size()> bounds = [] {
+    std::array<uint64_t, BOUNDS::size()> bounds{};
+    BOUNDS list;
+    for(size_t i = 0 ; i < BOUNDS::size() ; ++i) {
+      bounds[i] = uint64_t(list[i]);
+      if(i > 0 && bounds[i] <= bounds[i - 1]) {
+	throw std::invalid_argument("thistogram bounds must be ascending");
+      }
+    }
+    return bounds;
+  }();
+
+  // first_bound[m] is the first bound >= 2^m, where a value whose top bit is m starts looking
+  static constexpr std::array<uint16_t, 64> first_bound = [] {
+    static_assert(BOUNDS::size() < 65535, "thistogram supports up to 65534 bounds");
+    std::array<uint16_t, 64> first{};
+    for(size_t m = 0 ; m < 64 ; ++m) {
+      size_t i = 0;
+      while(i < BOUNDS::size() && bounds[i] < (uint64_t(1) << m)) {
+	++i;
+      }
+      first[m] = uint16_t(i);
+    }
+    return first;
+  }();
+
+  // bucket i holds values in (bounds[i - 1], bounds[i]], the last one values above every bound
+  static constexpr size_t bucket_of(uint64_t v_) {
+    size_t i = v_ == 0 ? 0 : first_bound[63 - std::countl_zero(v_)];
+    while(i < BOUNDS::size() && bounds[i] < v_) {
+      ++i;
+    }
+    return i;
+  }
+
+  struct snapshot_type {
+    std::array<uint64_t, BOUNDS::size() + 1> counts{};
+    uint64_t sum = 0;
+
+    uint64_t count() const {
+      uint64_t n = 0;
+      for(uint64_t c : counts) {
+	n += c;
+      }
+      return n;
+    }
+
+    double mean() const { return count() ? double(sum) / count() : 0; }
+
+    // upper bound of the bucket holding the q_ quantile (UINT64_MAX for the overflow bucket)
+    uint64_t quantile(double q_) const {
+      uint64_t rank = uint64_t(q_ * count());
+      uint64_t seen = 0;
+      for(size_t i = 0 ; i < counts.size() ; ++i) {
+	seen += counts[i];
+	if(seen > rank) {
+	  return i < BOUNDS::size() ? bounds[i] : UINT64_MAX;
+	}
+      }
+      return UINT64_MAX;
+    }
+  };
+
+  void record(uint64_t v_) {
+    tbump(_counts[bucket_of(v_)], 1);
+    tbump(_sum, v_);
+  }
+
+  void merge_into(snapshot_type &snapshot_) const {
+    for(size_t i = 0 ; i < buckets() ; ++i) {
+      snapshot_.counts[i] += _counts[i].load(std::memory_order_relaxed);
+    }
+    snapshot_.sum += _sum.load(std::memory_order_relaxed);
+  }
+
+private:
+  std::array<std::atomic<uint64_t>, BOUNDS::size() + 1> _counts{};
+  std::atomic<uint64_t> _sum{0};
+};
+
+// runs fn_ every period_ on a background thread until destroyed (and once more then)
+class taggregator
+{
+public:
+  template <typename REP, typename PERIOD>
+  taggregator(std::chrono::duration<REP, PERIOD> period_, std::function<void()> fn_)
+    : _thread([period = std::chrono::duration_cast<std::chrono::nanoseconds>(period_), fn = std::move(fn_)](std::stop_token stop_) {
+	std::mutex mutex;
+	std::condition_variable_any wake;
+	std::unique_lock lock(mutex);
+	do {
+	  wake.wait_for(lock, stop_, period, [] { return false; });
+	  fn();
+	} while(!stop_.stop_requested());
+      }) {}
+
+private:
+  std::jthread _thread;
+};
+
+#endif
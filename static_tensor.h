@@ -0,0 +1,268 @@
+#ifndef __STATIC_TENSOR_H__
+#define __STATIC_TENSOR_H__
+
+#include <array>
+#include <type_traits>
+
+#include "static_types.h"
+
+// static multi-dimensional parameter grids: the shape is a template parameter, so every
+// stride is a constant and index math folds into the addressing
+//
+// typedef ttensor<tlist<double, ...24 values...>, tshape<2, 3, 4>> coefs; // venue x side x level
+// coefs()(1, 2, 3);                    // one load at a constant offset from i, j, k
+// coefs::get<1, 0, 2>();               // folded at compile time
+// auto bid = coefs::slice<1>(0);       // a 2 x 4 view of side 0, nothing copied
+// bid(1, 3);
+// auto per_level = coefs::sum<0>();    // std::array<double, 12>, the 3 x 4 sums over venues
+//
+// values are given in row-major order, and stored either row-major (trow_major) or with
+// one axis blocked (tblocked<AXIS, B>): that axis is split into blocks of B whose lanes
+// are stored innermost, i.e. a 2 x 3 x 4 grid blocked on axis 0 by 2 is laid out as
+// [1][3][4][2] -- reductions along the blocked axis then add whole runs of lanes
+// element-wise instead of summing across a row
+//
+// reductions walk the storage so the innermost loop is contiguous in both the input and
+// the accumulators (which the compiler vectorizes); the one case that can't be done that
+// way is reducing the innermost axis of a row-major grid, which is what blocking is for
+
+template <size_t... DIMS>
+struct tshape
+{
+  static_assert(sizeof...(DIMS) > 0 && ((DIMS > 0) && ...), "tshape needs at least one axis and no empty axes");
+
+  static constexpr size_t rank() { return sizeof...(DIMS); }
+  static constexpr size_t size() { return (DIMS * ...); }
+
+  static constexpr std::array<size_t, sizeof...(DIMS)> extents = {DIMS...};
+};
+
+struct trow_major
+{
+  static constexpr size_t axis = 0;
+  static constexpr size_t block = 1;
+};
+
+template <size_t AXIS, size_t BLOCK>
+struct tblocked
+{
+  static_assert(BLOCK > 0, "tblocked block can't be empty");
+
+  static constexpr size_t axis = AXIS;
+  static constexpr size_t block = BLOCK;
+};
+
+// how a (possibly sliced) grid is addressed: index i on axis k contributes
+// (i / blocks[k]) * strides[k] + (i % blocks[k]) * lane_strides[k], where blocks[k] is 1
+// for every axis but a blocked one
+template <size_t RANK>
+struct ttensor_desc
+{
+  std::array<size_t, RANK> extents{};
+  std::array<size_t, RANK> strides{};
+  std::array<size_t, RANK> blocks{};
+  std::array<size_t, RANK> lane_strides{};
+
+  constexpr size_t offset_of(size_t axis_, size_t i_) const {
+    return blocks[axis_] == 1 ? i_ * strides[axis_] : (i_ / blocks[axis_]) * strides[axis_] + (i_ % blocks[axis_]) * lane_strides[axis_];
+  }
+
+  constexpr size_t offset(const std::array<size_t, RANK> &i_) const {
+    size_t offset = 0;
+    for(size_t k = 0 ; k < RANK ; ++k) {
+      offset += offset_of(k, i_[k]);
+    }
+    return offset;
+  }
+
+  // the addressing left after fixing an index on axis_
+  constexpr ttensor_desc<RANK - 1> drop(size_t axis_) const {
+    ttensor_desc<RANK - 1> d;
+    for(size_t k = 0, n = 0 ; k < RANK ; ++k) {
+      if(k != axis_) {
+	d.extents[n] = extents[k];
+	d.strides[n] = strides[k];
+	d.blocks[n] = blocks[k];
+	d.lane_strides[n] = lane_strides[k];
+	++n;
+      }
+    }
+    return d;
+  }
+};
+
+// a non-owning view of a grid (or a slice of one) with constant addressing
+template <typename T, auto DESC>
+class ttensor_view
+{
+public:
+  static constexpr size_t rank() { return DESC.extents.size(); }
+  static constexpr size_t extent(size_t axis_) { return DESC.extents[axis_]; }
+
+  constexpr explicit ttensor_view(const T *data_) : _data(data_) {}
+
+  template <typename... I> requires (sizeof...(I) == DESC.extents.size())
+    constexpr T operator()(I... i_) const { return _data[DESC.offset({size_t(i_)...})]; }
+
+  // the view with index i_ fixed on AXIS, one rank lower
+  template <size_t AXIS> requires (AXIS < DESC.extents.size() && DESC.extents.size() > 1)
+    constexpr ttensor_view<T, DESC.drop(AXIS)> slice(size_t i_) const {
+    return ttensor_view<T, DESC.drop(AXIS)>(_data + DESC.offset_of(AXIS, i_));
+  }
+
+  constexpr const T *data() const { return _data; }
+
+private:
+  const T *_data;
+};
+
+template <typename LIST, typename SHAPE, typename LAYOUT = trow_major>
+struct ttensor
+{
+  typedef typename LIST::value_type value_type;
+  typedef SHAPE shape_type;
+  typedef LAYOUT layout_type;
+
+  static constexpr size_t rank() { return SHAPE::rank(); }
+  static constexpr size_t size() { return SHAPE::size(); }
+  static constexpr size_t extent(size_t axis_) { return SHAPE::extents[axis_]; }
+
+  static_assert(LIST::size() == SHAPE::size(), "ttensor needs one value per element of its shape");
+  static_assert(LAYOUT::axis < SHAPE::rank() && SHAPE::extents[LAYOUT::axis] % LAYOUT::block == 0,
+		"ttensor blocked axis must exist and be a multiple of the block");
+
+  // extents of the stored array: each axis (the blocked one divided by the block), then
+  // the lanes of the blocked axis
+  static constexpr std::array<size_t, SHAPE::rank() + 1> storage_extents = [] {
+    std::array<size_t, SHAPE::rank() + 1> e{};
+    for(size_t k = 0 ; k < rank() ; ++k) {
+      e[k] = k == LAYOUT::axis ? extent(k) / LAYOUT::block : extent(k);
+    }
+    e[rank()] = LAYOUT::block;
+    return e;
+  }();
+
+  static constexpr ttensor_desc<SHAPE::rank()> desc = [] {
+    ttensor_desc<SHAPE::rank()> d;
+    size_t stride = LAYOUT::block;
+    for(size_t k = rank() ; k-- > 0 ; ) {
+      d.extents[k] = extent(k);
+      d.strides[k] = stride;
+      d.blocks[k] = k == LAYOUT::axis ? LAYOUT::block : 1;
+      d.lane_strides[k] = 1;
+      stride *= storage_extents[k];
+    }
+    return d;
+  }();
+
+  // row-major position i_ as an index per axis
+  static constexpr std::array<size_t, SHAPE::rank()> unravel(size_t i_) {
+    std::array<size_t, SHAPE::rank()> idx{};
+    for(size_t k = rank() ; k-- > 0 ; ) {
+      idx[k] = i_ % extent(k);
+      i_ /= extent(k);
+    }
+    return idx;
+  }
+
+  // the values in storage order
+  static constexpr std::array<value_type, SHAPE::size()> values = [] {
+    std::array<value_type, SHAPE::size()> values{};
+    LIST list;
+    for(size_t i = 0 ; i < size() ; ++i) {
+      values[desc.offset(unravel(i))] = list[i];
+    }
+    return values;
+  }();
+
+  template <typename... I> requires (sizeof...(I) == SHAPE::rank())
+    constexpr value_type operator()(I... i_) const { return values[desc.offset({size_t(i_)...})]; }
+
+  template <size_t... I> requires (sizeof...(I) == SHAPE::rank())
+    static constexpr value_type get() {
+    static_assert([] {
+	std::array<size_t, SHAPE::rank()> idx = {I...};
+	for(size_t k = 0 ; k < rank() ; ++k) {
+	  if(idx[k] >= extent(k)) {
+	    return false;
+	  }
+	}
+	return true;
+      }(), "index out of range in ttensor");
+    return values[desc.offset({I...})];
+  }
+
+  static constexpr ttensor_view<value_type, desc> view() { return ttensor_view<value_type, desc>(values.data()); }
+
+  template <size_t AXIS> requires (AXIS < SHAPE::rank() && SHAPE::rank() > 1)
+    static constexpr auto slice(size_t i_) { return view().template slice<AXIS>(i_); }
+
+  // op_ folded along AXIS, as a row-major array over the other axes
+  template <size_t AXIS, typename OP> requires (AXIS < SHAPE::rank())
+    static constexpr std::array<value_type, SHAPE::size() / SHAPE::extents[AXIS]> reduce(OP op_) {
+    // storage is [outer][mid][inner] with mid the reduced axis' blocks (inner includes
+    // the lanes), and partial[outer][inner] accumulates over mid
+    constexpr size_t outer = [] {
+      size_t n = 1;
+      for(size_t k = 0 ; k < AXIS ; ++k) {
+	n *= storage_extents[k];
+      }
+      return n;
+    }();
+    constexpr size_t mid = storage_extents[AXIS];
+    constexpr size_t inner = size() / (outer * mid);
+
+    std::array<value_type, outer * inner> partial{};
+    for(size_t o = 0 ; o < outer ; ++o) {
+      for(size_t t = 0 ; t < inner ; ++t) {
+	partial[o * inner + t] = values[o * mid * inner + t];
+      }
+      for(size_t m = 1 ; m < mid ; ++m) {
+	const value_type *in = values.data() + (o * mid + m) * inner;
+	value_type *acc = partial.data() + o * inner;
+	for(size_t t = 0 ; t < inner ; ++t) {
+	  acc[t] = op_(acc[t], in[t]);
+	}
+      }
+    }
+
+    // the partial sums are addressed like the grid with AXIS's blocks removed (so axes
+    // before it shrink their stride by mid); when AXIS is the blocked one its lanes are
+    // still to be folded
+    constexpr ttensor_desc<SHAPE::rank() - 1> pdesc = [] {
+      ttensor_desc<SHAPE::rank()> d = desc;
+      for(size_t k = 0 ; k < AXIS ; ++k) {
+	d.strides[k] /= mid;
+      }
+      return d.drop(AXIS);
+    }();
+    constexpr size_t lanes = AXIS == LAYOUT::axis ? LAYOUT::block : 1;
+
+    std::array<value_type, SHAPE::size() / SHAPE::extents[AXIS]> out{};
+    for(size_t r = 0 ; r < out.size() ; ++r) {
+      std::array<size_t, SHAPE::rank() - 1> idx{};
+      for(size_t k = SHAPE::rank() - 1, rest = r ; k-- > 0 ; ) {
+	idx[k] = rest % pdesc.extents[k];
+	rest /= pdesc.extents[k];
+      }
+      size_t p = pdesc.offset(idx);
+      value_type v = partial[p];
+      for(size_t l = 1 ; l < lanes ; ++l) {
+	v = op_(v, partial[p + l]);
+      }
+      out[r] = v;
+    }
+    return out;
+  }
+
+  template <size_t AXIS>
+    static constexpr auto sum() { return reduce<AXIS>([](value_type a_, value_type b_) { return a_ + b_; }); }
+
+  template <size_t AXIS>
+    static constexpr auto max() { return reduce<AXIS>([](value_type a_, value_type b_) { return b_ > a_ ? b_ : a_; }); }
+
+  template <size_t AXIS>
+    static constexpr auto min() { return reduce<AXIS>([](value_type a_, value_type b_) { return b_ < a_ ? b_ : a_; }); }
+};
+
+#endif
@@ -0,0 +1,156 @@
+#ifndef __STATIC_TREE_H__
+#define __STATIC_TREE_H__
+
+#include <array>
+#include <bit>
+
+#include "static_types.h"
+
+// static decision trees and tree ensembles (gbdt style) whose splits and leaf values
+// are template parameters, so evaluation needs no node arrays to be interpreted
+//
+// a tree is built out of tnode and tleaf -- a row goes left when row[FEATURE] <= THRESHOLD:
+//
+// typedef tnode<0, 1.5,
+//               tleaf<-1.0>,
+//               tnode<2, 0.25, tleaf<0.5>, tleaf<2.0>>> tree;
+// tforest<ttree_eval::bitmask, tree, other_tree> model;
+// double score = model.eval(row);
+
+// how a tforest evaluates its trees
+enum class ttree_eval {
+  branch,  // nested branches, one compare and jump per level on the taken path
+  bitmask  // branch-free "QuickScorer": every split is tested and masks off leaves
+};
+
+template <double VALUE>
+struct tleaf
+{
+  static constexpr size_t leaves() { return 1; }
+  static constexpr size_t nodes() { return 0; }
+
+  static constexpr double eval(const double *) { return VALUE; }
+
+  template <typename NODES>
+    static constexpr void flatten(NODES &, size_t &, double *leaves_, size_t &leaf_) {
+    leaves_[leaf_++] = VALUE;
+  }
+};
+
+template <size_t FEATURE, double THRESHOLD, typename LEFT, typename RIGHT>
+struct tnode
+{
+  static constexpr size_t leaves() { return LEFT::leaves() + RIGHT::leaves(); }
+  static constexpr size_t nodes() { return 1 + LEFT::nodes() + RIGHT::nodes(); }
+
+  static constexpr double eval(const double *row_) {
+    if(row_[FEATURE] <= THRESHOLD) {
+      return LEFT::eval(row_);
+    }
+    return RIGHT::eval(row_);
+  }
+
+  // emit this subtree's splits in preorder and its leaves left to right -- each split
+  // carries the mask of leaves that survive when the row goes right (i.e. everything
+  // except its left subtree)
+  template <typename NODES>
+    static constexpr void flatten(NODES &nodes_, size_t &node_, double *leaves_, size_t &leaf_) {
+    uint64_t left = (LEFT::leaves() == 64 ? ~uint64_t(0) : ((uint64_t(1) << LEFT::leaves()) - 1)) << leaf_;
+    nodes_[node_++] = {FEATURE, THRESHOLD, ~left};
+    LEFT::flatten(nodes_, node_, leaves_, leaf_);
+    RIGHT::flatten(nodes_, node_, leaves_, leaf_);
+  }
+};
+
+// one split of a flattened tree
+struct tsplit
+{
+  size_t feature;
+  double threshold;
+  uint64_t mask;
+};
+
+// the flattened form of a single tree used by the bitmask evaluator
+template <typename TREE>
+struct ttree_tables
+{
+  static_assert(TREE::leaves() <= 64, "bitmask evaluation supports at most 64 leaves per tree");
+
+  struct tables {
+    std::array<tsplit, TREE::nodes()> splits;
+    std::array<double, TREE::leaves()> leaves;
+  };
+
+  static constexpr tables value = [] {
+    tables t{};
+    size_t node = 0;
+    size_t leaf = 0;
+    TREE::flatten(t.splits, node, t.leaves.data(), leaf);
+    return t;
+  }();
+
+  // the surviving leaf with the lowest index is the exit leaf
+  static constexpr double eval(const double *row_) {
+    uint64_t mask = ~uint64_t(0);
+    for(size_t k = 0 ; k < TREE::nodes() ; ++k) {
+      const tsplit &s = value.splits[k];
+      mask &= s.mask | (uint64_t(0) - uint64_t(row_[s.feature] <= s.threshold));
+    }
+    return value.leaves[std::countr_zero(mask)];
+  }
+
+  // evaluate a block of rows, testing each split across the whole block at once so the
+  // inner loop vectorizes over rows
+  template <size_t BLOCK>
+    static constexpr void eval_block(const double *rows_, size_t n_, size_t stride_, double *out_) {
+    uint64_t masks[BLOCK];
+    for(size_t r = 0 ; r < n_ ; ++r) {
+      masks[r] = ~uint64_t(0);
+    }
+    for(size_t k = 0 ; k < TREE::nodes() ; ++k) {
+      const tsplit &s = value.splits[k];
+      for(size_t r = 0 ; r < n_ ; ++r) {
+	masks[r] &= s.mask | (uint64_t(0) - uint64_t(rows_[r * stride_ + s.feature] <= s.threshold));
+      }
+    }
+    for(size_t r = 0 ; r < n_ ; ++r) {
+      out_[r] += value.leaves[std::countr_zero(masks[r])];
+    }
+  }
+};
+
+// an additive ensemble of static trees, evaluated as selected by MODE
+template <ttree_eval MODE, typename... TREES>
+struct tforest
+{
+  static constexpr size_t size() { return sizeof...(TREES); }
+
+  // score one row (row_ must hold every feature the trees split on)
+  static constexpr double eval(const double *row_) {
+    if constexpr (MODE == ttree_eval::branch) {
+      return (0.0 + ... + TREES::eval(row_));
+    } else {
+      return (0.0 + ... + ttree_tables<TREES>::eval(row_));
+    }
+  }
+
+  // score n_ rows spaced stride_ doubles apart, writing one score per row to out_
+  static constexpr void eval_batch(const double *rows_, size_t n_, size_t stride_, double *out_) {
+    if constexpr (MODE == ttree_eval::branch) {
+      for(size_t r = 0 ; r < n_ ; ++r) {
+	out_[r] = eval(rows_ + r * stride_);
+      }
+    } else {
+      constexpr size_t block = 16;
+      for(size_t r = 0 ; r < n_ ; r += block) {
+	size_t len = n_ - r < block ? n_ - r : block;
+	for(size_t i = 0 ; i < len ; ++i) {
+	  out_[r + i] = 0;
+	}
+	(ttree_tables<TREES>::template eval_block<block>(rows_ + r * stride_, len, stride_, out_ + r), ...);
+      }
+    }
+  }
+};
+
+#endif
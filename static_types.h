@@ -1,7 +1,11 @@
 #ifndef __STATIC_TYPES_H__
 #define __STATIC_TYPES_H__
 
+#include <array>
+#include <span>
+#include <string_view>
 #include <tuple>
+#include <type_traits>
 
 #include <stddef.h>
 #include <stdint.h>
@@ -22,12 +26,124 @@ struct tlist
 // this template struct can store a heterogenous list
 // and invoke a visitor across all of them, or just one of them
 // -- this can potentially be all done at compile time
+//
+// elements can also be picked out by type: get<T>() for the element of type T, and
+// visit_if<PRED>() / visit_each<T>() / visit_grouped() to visit a subset (or every
+// element, type by type) -- the subset is computed at compile time, so the visitor is
+// only instantiated for the types it gets, without runtime ifs:
+//
+// template <typename T> using batched = std::bool_constant<requires(T &t) { t.update_batch(); }>;
+// models.visit_if<batched>([](auto &m) { m.update_batch(); });
+// typedef decltype(models)::partition<batched> split; // split::first_type, split::second_type
 template <typename... ARGS>
 struct thlist {
+private:
+  template <typename T>
+  struct tsame_as {
+    template <typename U>
+    using pred = std::is_same<T, U>;
+  };
+
+  template <template <typename> typename PRED>
+  struct tnot {
+    template <typename U>
+    using pred = std::negation<PRED<U>>;
+  };
+
+  template <auto INDICES, typename = std::make_index_sequence<INDICES.size()>>
+  struct tselect;
+
+  template <auto INDICES, size_t... I>
+  struct tselect<INDICES, std::index_sequence<I...>> {
+    typedef thlist<std::tuple_element_t<INDICES[I], std::tuple<ARGS...>>...> type;
+  };
+
+public:
   static constexpr size_t size() { return sizeof...(ARGS); }
   
   std::tuple<ARGS...> items = {ARGS()...};
-  
+
+  template <size_t N> requires (N < sizeof...(ARGS))
+  using type_at = std::tuple_element_t<N, std::tuple<ARGS...>>;
+
+  // number of elements of type T
+  template <typename T>
+  static constexpr size_t count_of() { return (size_t(std::is_same_v<T, ARGS>) + ... + 0); }
+
+  // index of the first element of type T
+  template <typename T>
+  static constexpr size_t index_of()
+  {
+    constexpr bool same[] = {std::is_same_v<T, ARGS>..., false};
+    static_assert(count_of<T>() > 0, "no element of this type in thlist");
+    size_t i = 0;
+    while(!same[i]) {
+      ++i;
+    }
+    return i;
+  }
+
+  template <size_t N> requires (N < sizeof...(ARGS))
+  constexpr auto &get() { return std::get<N>(items); }
+
+  // the element of type T (which must be the only one of that type)
+  template <typename T>
+  constexpr T &get()
+  {
+    static_assert(count_of<T>() == 1, "thlist get<T>() needs exactly one element of type T");
+    return std::get<index_of<T>()>(items);
+  }
+
+  // indices of the elements whose type satisfies PRED (a trait like std::is_trivial)
+  template <template <typename> typename PRED>
+  static constexpr std::array<size_t, (size_t(bool(PRED<ARGS>::value)) + ... + 0)> indices_if = [] {
+    std::array<size_t, (size_t(bool(PRED<ARGS>::value)) + ... + 0)> indices{};
+    constexpr bool keep[] = {bool(PRED<ARGS>::value)..., false};
+    for(size_t i = 0, n = 0 ; i < sizeof...(ARGS) ; ++i) {
+      if(keep[i]) {
+	indices[n++] = i;
+      }
+    }
+    return indices;
+  }();
+
+  // every index, with elements of the same type together (types in order of first appearance)
+  static constexpr std::array<size_t, sizeof...(ARGS)> grouped = [] {
+    std::array<size_t, sizeof...(ARGS)> indices{};
+    constexpr size_t first[] = {index_of<ARGS>()..., 0};
+    for(size_t i = 0, n = 0 ; i < sizeof...(ARGS) ; ++i) {
+      for(size_t j = i ; first[i] == i && j < sizeof...(ARGS) ; ++j) {
+	if(first[j] == i) {
+	  indices[n++] = j;
+	}
+      }
+    }
+    return indices;
+  }();
+
+  // number of distinct element types
+  static constexpr size_t distinct()
+  {
+    constexpr size_t first[] = {index_of<ARGS>()..., 0};
+    size_t n = 0;
+    for(size_t i = 0 ; i < sizeof...(ARGS) ; ++i) {
+      n += first[i] == i;
+    }
+    return n;
+  }
+
+  // index of the first element of each distinct type
+  static constexpr std::array<size_t, distinct()> unique_indices = [] {
+    std::array<size_t, distinct()> indices{};
+    constexpr size_t first[] = {index_of<ARGS>()..., 0};
+    for(size_t i = 0, n = 0 ; i < sizeof...(ARGS) ; ++i) {
+      if(first[i] == i) {
+	indices[n++] = i;
+      }
+    }
+    return indices;
+  }();
+
   template <size_t N, typename VISITOR> requires (N < sizeof...(ARGS))
     constexpr void visit(VISITOR visitor) {
     visitor(std::get<N>(items));    
@@ -45,22 +161,74 @@ struct thlist {
     constexpr void ivisit(VISITOR visitor, size_t i) {
     if(i == N) {
       visitor(std::get<N>(items));
+      return;
     }
     if constexpr (N) {
       ivisit<N-1>(visitor, i);
+    } else {
+      throw std::out_of_range("out of range in ivisit");
     }
-    throw std::out_of_range("out of range in ivisit");
   }
 
   template <typename VISITOR> requires (sizeof...(ARGS) > 0)
   constexpr void visit(VISITOR visitor, size_t i) {
     ivisit<sizeof...(ARGS) - 1>(visitor, i);
   }
-  
+
+  // visit the elements whose type satisfies PRED, in order
+  template <template <typename> typename PRED, typename VISITOR>
+  constexpr void visit_if(VISITOR visitor) {
+    visit_indices<indices_if<PRED>>(visitor, std::make_index_sequence<indices_if<PRED>.size()>());
+  }
+
+  // visit the elements of type T, in order
+  template <typename T, typename VISITOR>
+  constexpr void visit_each(VISITOR visitor) {
+    visit_if<tsame_as<T>::template pred>(visitor);
+  }
+
+  // visit every element, all those of one type before moving on to the next type
+  template <typename VISITOR>
+  constexpr void visit_grouped(VISITOR visitor) {
+    visit_indices<grouped>(visitor, std::make_index_sequence<sizeof...(ARGS)>());
+  }
+
+  // the list of the element types satisfying PRED (or not), and both as a pair
+  template <template <typename> typename PRED>
+  using filter = typename tselect<indices_if<PRED>>::type;
+
+  template <template <typename> typename PRED>
+  using remove_if = filter<tnot<PRED>::template pred>;
+
+  template <template <typename> typename PRED>
+  using partition = std::pair<filter<PRED>, remove_if<PRED>>;
+
+  // the list of distinct element types, in order of first appearance
+  using unique = typename tselect<unique_indices>::type;
+
+private:
+  template <auto INDICES, typename VISITOR, size_t... I>
+  constexpr void visit_indices(VISITOR &visitor, std::index_sequence<I...>) {
+    (visitor(std::get<INDICES[I]>(items)), ...);
+  }
+};
+
+// a compile-time constant usable as a tmap key or scalar value
+// (for example std::pair<tval<42>, tval<0.5>>)
+template <auto V>
+using tval = std::integral_constant<decltype(V), V>;
+
+// how a tmap finds a key, chosen at compile time (see tmap::layout())
+enum class tmap_layout {
+  linear, // compare chain over the keys -- any key type (e.g. tstr), and what small maps fold best
+  dense,  // integral/enum keys in a compact range: one load from a table indexed by key - min
+  sorted  // integral/enum keys spread too thinly for a table: binary search over the sorted keys
 };
 
 // this template struct can store a compile-time initialized mapping from KEYs to VALUEs
-// note that since linear search is used, it's not recommended to make huge maps
+// note that for string keys linear search is used, so it's not recommended to make huge maps
+// of those -- maps with integral or enum keys (given as tval's) instead pick a dense table or
+// a sorted array at compile time, which tmap_layout_v reports
 //
 // in the case of a map from KEY to values that are lists (i.e. tlist or tstrlist)
 // we need to access them differently because they are not heterogeneous --
@@ -80,6 +248,11 @@ struct thlist {
 //   }
 //   std::cout << std::endl;
 //
+// map with integral keys example:
+// -------------------------------
+// tmap<int, double, std::pair<tval<1>, tval<0.5>>, std::pair<tval<2>, tval<0.25>>> bar;
+// bar[2]; // dense layout: a bounds check and two loads
+//
 template<typename KEY, typename VALUE, typename... KVPAIRS>
 struct tmap
 {
@@ -88,6 +261,132 @@ struct tmap
 
   // return number of keys in map
   static constexpr size_t size() { return sizeof...(KVPAIRS); }
+
+  static constexpr bool integral_keys() { return std::is_integral_v<KEY> || std::is_enum_v<KEY>; }
+
+  static constexpr tmap_layout layout()
+  {
+    if constexpr (!integral_keys() || sizeof...(KVPAIRS) == 0) {
+      return tmap_layout::linear;
+    } else {
+      // at least a quarter of the table slots must be used
+      return tindex<>::range <= 4 * size() ? tmap_layout::dense : tmap_layout::sorted;
+    }
+  }
+
+  // the position of key_ among KVPAIRS, or size() if it isn't in the map
+  static constexpr size_t slot_of(const KEY &key_)
+  {
+    if constexpr (layout() == tmap_layout::dense) {
+      uint64_t i = uint64_t(key_index(key_)) - uint64_t(tindex<>::min);
+      return i < tindex<>::range ? tindex<>::dense[i] : size();
+    } else if constexpr (layout() == tmap_layout::sorted) {
+      const auto &keys = tindex<>::sorted_keys;
+      size_t lo = 0;
+      size_t hi = size();
+      int64_t k = key_index(key_);
+      while(lo < hi) {
+	size_t mid = (lo + hi) / 2;
+	if(keys[mid] < k) {
+	  lo = mid + 1;
+	} else {
+	  hi = mid;
+	}
+      }
+      return lo < size() && keys[lo] == k ? tindex<>::sorted_slots[lo] : size();
+    } else {
+      size_t slot = 0;
+      ((KVPAIRS().first() == key_ || (++slot, false)) || ...);
+      return slot;
+    }
+  }
+
+  static constexpr bool contains(const KEY &key_) { return slot_of(key_) < size(); }
+
+  // slot_of() for a batch of up to 64 keys at once -- rather than finishing one key before
+  // starting the next, every step (hash or index, probe) is applied to the whole batch and
+  // the next step's memory is prefetched for all keys first, so the cache misses overlap
+  static constexpr void slots_of(std::span<const KEY> keys_, std::span<uint32_t> slots_)
+  {
+    if(keys_.size() > 64 || slots_.size() < keys_.size()) {
+      throw std::out_of_range("tmap batches take at most 64 keys and as many outputs");
+    }
+    size_t n = keys_.size();
+    if constexpr (layout() == tmap_layout::dense) {
+      for(size_t i = 0 ; i < n ; ++i) {
+	uint64_t index = uint64_t(key_index(keys_[i])) - uint64_t(tindex<>::min);
+	slots_[i] = uint32_t(index < tindex<>::range ? index : tindex<>::range);
+	prefetch(&tindex<>::dense[slots_[i] < tindex<>::range ? slots_[i] : 0]);
+      }
+      for(size_t i = 0 ; i < n ; ++i) {
+	slots_[i] = slots_[i] < tindex<>::range ? tindex<>::dense[slots_[i]] : uint32_t(size());
+      }
+    } else if constexpr (layout() == tmap_layout::sorted) {
+      // branch-free lower bound, one halving step for every key per round
+      const auto &keys = tindex<>::sorted_keys;
+      for(size_t i = 0 ; i < n ; ++i) {
+	slots_[i] = 0;
+      }
+      for(size_t len = size() ; len > 1 ; len -= len / 2) {
+	size_t half = len / 2;
+	for(size_t i = 0 ; i < n ; ++i) {
+	  prefetch(&keys[slots_[i] + half / 2]);
+	  prefetch(&keys[slots_[i] + half + half / 2]);
+	}
+	for(size_t i = 0 ; i < n ; ++i) {
+	  slots_[i] += keys[slots_[i] + half] < key_index(keys_[i]) ? half : 0;
+	}
+      }
+      for(size_t i = 0 ; i < n ; ++i) {
+	int64_t k = key_index(keys_[i]);
+	size_t pos = slots_[i] + (keys[slots_[i]] < k);
+	slots_[i] = pos < size() && keys[pos] == k ? tindex<>::sorted_slots[pos] : uint32_t(size());
+      }
+    } else if constexpr (std::is_convertible_v<const KEY &, std::string_view> && sizeof...(KVPAIRS) > 0) {
+      // string keys go through a compile-time open-addressed hash index
+      typedef thashed<> hashed;
+      uint64_t hashes[64];
+      for(size_t i = 0 ; i < n ; ++i) {
+	hashes[i] = hashed::hash(keys_[i]);
+	prefetch(&hashed::table[hashes[i] & hashed::mask]);
+      }
+      for(size_t i = 0 ; i < n ; ++i) {
+	size_t h = hashes[i] & hashed::mask;
+	while(hashed::table[h] != size() && hashed::keys[hashed::table[h]] != std::string_view(keys_[i])) {
+	  h = (h + 1) & hashed::mask;
+	}
+	slots_[i] = hashed::table[h];
+      }
+    } else {
+      for(size_t i = 0 ; i < n ; ++i) {
+	slots_[i] = uint32_t(slot_of(keys_[i]));
+      }
+    }
+  }
+
+  // look up a batch of up to 64 keys (see slots_of), writing out_[i] = (*this)[keys_[i]]
+  // for every key present -- bit i of the result is set if keys_[i] is missing, in which
+  // case out_[i] is left alone
+  constexpr uint64_t lookup_batch(std::span<const KEY> keys_, std::span<VALUE> out_) const
+  {
+    if(out_.size() < keys_.size()) {
+      throw std::out_of_range("tmap batches take at most 64 keys and as many outputs");
+    }
+    uint32_t slots[64];
+    slots_of(keys_, std::span<uint32_t>(slots, keys_.size() <= 64 ? keys_.size() : 0));
+    for(size_t i = 0 ; i < keys_.size() ; ++i) {
+      prefetch(&tscalars<>::values[slots[i] < size() ? slots[i] : 0]);
+    }
+    uint64_t misses = 0;
+    for(size_t i = 0 ; i < keys_.size() ; ++i) {
+      if(slots[i] < size()) {
+	out_[i] = tscalars<>::values[slots[i]];
+      } else {
+	misses |= uint64_t(1) << i;
+      }
+    }
+    return misses;
+  }
   
   template <size_t N, typename KV, typename... REST> requires (N < sizeof...(KVPAIRS))
     static constexpr size_t size_helper(const KEY &key_)
@@ -103,13 +402,21 @@ struct tmap
   }
 
   // get the number of values in a tlist associated with key_
-  static constexpr size_t size(const KEY& key_) { return size_helper<sizeof...(KVPAIRS) - 1, KVPAIRS...>(key_); }
+  static constexpr size_t size(const KEY& key_)
+  {
+    if constexpr (layout() == tmap_layout::linear) {
+      return size_helper<sizeof...(KVPAIRS) - 1, KVPAIRS...>(key_);
+    } else {
+      size_t slot = checked_slot(key_);
+      return tlists<>::offsets[slot + 1] - tlists<>::offsets[slot];
+    }
+  }
   
   template <size_t N, typename KV, typename... REST> requires (N < sizeof...(KVPAIRS))
     constexpr VALUE index_helper(const KEY &key_) const
   {
     if (KV().first() == key_) {
-      return KV().second;
+      return tscalars<>::scalar(KV().second);
     }
     if constexpr (N) {
       return index_helper<N-1, REST...>(key_);
@@ -121,7 +428,11 @@ struct tmap
   // get the value associated with key_
   constexpr VALUE operator[](const KEY& key_) const
   {
-    return index_helper<sizeof...(KVPAIRS) - 1, VALUE, KVPAIRS...>(key_);
+    if constexpr (layout() == tmap_layout::linear) {
+      return index_helper<sizeof...(KVPAIRS) - 1, KVPAIRS...>(key_);
+    } else {
+      return tscalars<>::values[checked_slot(key_)];
+    }
   }
 
   template <size_t N, typename KV, typename... REST> requires (N < sizeof...(KVPAIRS))
@@ -141,10 +452,195 @@ struct tmap
   // note: with high enough version of gcc + c++23 can do [,] notation instead  
   constexpr VALUE operator()(const KEY &key_, size_t i_) const  
   {
-    return get_helper<sizeof...(KVPAIRS) - 1, KVPAIRS...>(key_, i_);
+    if constexpr (layout() == tmap_layout::linear) {
+      return get_helper<sizeof...(KVPAIRS) - 1, KVPAIRS...>(key_, i_);
+    } else {
+      return tlists<>::values[tlists<>::offsets[checked_slot(key_)] + i_];
+    }
   }  
+
+private:
+  static constexpr int64_t key_index(const KEY &key_)
+  {
+    if constexpr (std::is_enum_v<KEY>) {
+      return int64_t(std::underlying_type_t<KEY>(key_));
+    } else {
+      return int64_t(key_);
+    }
+  }
+
+  static constexpr size_t checked_slot(const KEY &key_)
+  {
+    size_t slot = slot_of(key_);
+    if(slot == size()) {
+      throw std::out_of_range("couldn't find key in tmap");
+    }
+    return slot;
+  }
+
+  // key lookup tables for integral keys (a template so they're only built when used)
+  template <bool = true>
+  struct tindex {
+    static constexpr std::array<int64_t, sizeof...(KVPAIRS)> keys = {key_index(KVPAIRS().first())...};
+
+    static constexpr int64_t min = [] {
+      int64_t m = keys[0];
+      for(int64_t k : keys) {
+	m = k < m ? k : m;
+      }
+      return m;
+    }();
+
+    // max - min + 1, in unsigned arithmetic so any spread of keys fits (saturating when the
+    // keys span all of int64_t)
+    static constexpr uint64_t range = [] {
+      int64_t m = keys[0];
+      for(int64_t k : keys) {
+	m = k > m ? k : m;
+      }
+      uint64_t span = uint64_t(m) - uint64_t(min);
+      return span == UINT64_MAX ? span : span + 1;
+    }();
+
+    static_assert([] {
+	for(size_t i = 0 ; i < keys.size() ; ++i) {
+	  for(size_t j = 0 ; j < i ; ++j) {
+	    if(keys[i] == keys[j]) {
+	      return false;
+	    }
+	  }
+	}
+	return true;
+      }(), "duplicate key in tmap");
+
+    static constexpr std::array<uint32_t, range <= 4 * sizeof...(KVPAIRS) ? range : 1> dense = [] {
+      std::array<uint32_t, range <= 4 * sizeof...(KVPAIRS) ? range : 1> table{};
+      for(auto &t : table) {
+	t = uint32_t(sizeof...(KVPAIRS));
+      }
+      if(range <= 4 * sizeof...(KVPAIRS)) {
+	for(size_t i = 0 ; i < keys.size() ; ++i) {
+	  table[uint64_t(keys[i]) - uint64_t(min)] = uint32_t(i);
+	}
+      }
+      return table;
+    }();
+
+    static constexpr std::array<uint32_t, sizeof...(KVPAIRS)> sorted_slots = [] {
+      std::array<uint32_t, sizeof...(KVPAIRS)> slots{};
+      for(size_t i = 0 ; i < slots.size() ; ++i) {
+	slots[i] = uint32_t(i);
+      }
+      for(size_t i = 1 ; i < slots.size() ; ++i) {
+	for(size_t j = i ; j > 0 && keys[slots[j]] < keys[slots[j - 1]] ; --j) {
+	  uint32_t t = slots[j];
+	  slots[j] = slots[j - 1];
+	  slots[j - 1] = t;
+	}
+      }
+      return slots;
+    }();
+
+    static constexpr std::array<int64_t, sizeof...(KVPAIRS)> sorted_keys = [] {
+      std::array<int64_t, sizeof...(KVPAIRS)> sorted{};
+      for(size_t i = 0 ; i < sorted.size() ; ++i) {
+	sorted[i] = keys[sorted_slots[i]];
+      }
+      return sorted;
+    }();
+  };
+
+  static constexpr void prefetch(const void *p_)
+  {
+    if(!std::is_constant_evaluated()) {
+      __builtin_prefetch(p_);
+    }
+  }
+
+  // string key hash index used by slots_of: a power-of-two table of slots (size() when
+  // empty) with linear probing, at most half full
+  template <bool = true>
+  struct thashed {
+    static constexpr std::array<std::string_view, sizeof...(KVPAIRS)> keys = {std::string_view(KVPAIRS().first())...};
+
+    static constexpr size_t buckets = [] {
+      size_t n = 1;
+      while(n < 2 * sizeof...(KVPAIRS)) {
+	n *= 2;
+      }
+      return n;
+    }();
+
+    static constexpr size_t mask = buckets - 1;
+
+    static constexpr uint64_t hash(std::string_view s_)
+    {
+      uint64_t h = 14695981039346656037ull;
+      for(char c : s_) {
+	h = (h ^ uint8_t(c)) * 1099511628211ull;
+      }
+      return h ^ (h >> 32);
+    }
+
+    static constexpr std::array<uint32_t, buckets> table = [] {
+      std::array<uint32_t, buckets> table{};
+      for(auto &t : table) {
+	t = uint32_t(sizeof...(KVPAIRS));
+      }
+      for(size_t i = 0 ; i < keys.size() ; ++i) {
+	size_t h = hash(keys[i]) & mask;
+	while(table[h] != sizeof...(KVPAIRS)) {
+	  h = (h + 1) & mask;
+	}
+	table[h] = uint32_t(i);
+      }
+      return table;
+    }();
+  };
+
+  // scalar values by slot (a value may be anything convertible to VALUE, or a tstr)
+  template <bool = true>
+  struct tscalars {
+    template <typename V>
+    static constexpr VALUE scalar(const V &v_)
+    {
+      if constexpr (std::is_convertible_v<const V &, VALUE>) {
+	return VALUE(v_);
+      } else {
+	return VALUE(v_());
+      }
+    }
+
+    static constexpr std::array<VALUE, sizeof...(KVPAIRS)> values = {scalar(KVPAIRS().second)...};
+  };
+
+  // list values flattened by slot, with offsets[slot] the start of each list
+  template <bool = true>
+  struct tlists {
+    static constexpr std::array<size_t, sizeof...(KVPAIRS) + 1> offsets = [] {
+      std::array<size_t, sizeof...(KVPAIRS) + 1> offsets{};
+      size_t i = 0;
+      ((offsets[i + 1] = offsets[i] + KVPAIRS().second.size(), ++i), ...);
+      return offsets;
+    }();
+
+    static constexpr std::array<VALUE, offsets[sizeof...(KVPAIRS)]> values = [] {
+      std::array<VALUE, offsets[sizeof...(KVPAIRS)]> values{};
+      size_t n = 0;
+      ([&] {
+	for(size_t i = 0 ; i < KVPAIRS().second.size() ; ++i) {
+	  values[n++] = KVPAIRS().second[i];
+	}
+      }(), ...);
+      return values;
+    }();
+  };
 };
 
+// the lookup layout a tmap picked for its keys
+template <typename MAP>
+inline constexpr tmap_layout tmap_layout_v = MAP::layout();
+
 // we have to use a macro for our tstr "type"
 #define tstr(s) decltype([](){ return std::string_view(s); })
 
@@ -160,8 +656,8 @@ struct tstrlist
     if (i == N) {
       return T()();
     }
-    if constexpr (N) {
-      return get_helper<N-1, REST...>(i);
+    if constexpr (sizeof...(REST)) {
+      return get_helper<N+1, REST...>(i);
     }
     // oops, can't find
     throw std::out_of_range("index error in get_helper");
@@ -169,7 +665,7 @@ struct tstrlist
   
   constexpr std::string_view operator[](size_t i) const
   {
-    return get_helper<sizeof...(ARGS) - 1, ARGS...>(i);
+    return get_helper<0, ARGS...>(i);
   }  
 };
 
@@ -0,0 +1,195 @@
+#ifndef __STATIC_WINDOW_H__
+#define __STATIC_WINDOW_H__
+
+#include <array>
+#include <bit>
+#include <functional>
+#include <span>
+
+#include "static_types.h"
+
+// fixed-capacity history buffers for streaming filters: capacities are compile-time
+// constants rounded up to a power of two, so wrapping is a mask and nothing allocates
+//
+// typedef tlist<double, 0.4, 0.3, 0.2, 0.1> fir;  // coefficient k weights the kth most recent value
+// window_for<fir> w;                              // a twindow<double, 4>
+// w.push(x);
+// double y = w.dot<fir>();                        // one contiguous, unrolled multiply-add pass
+// double avg = w.mean();                          // running sum, updated per push
+// twindow_max<double, 64> hi;                     // running max over the last 64 values
+//
+// twindow stores every value twice (at i and i + capacity) so the last N values are
+// always one contiguous run, whatever the write position -- a push is two stores and
+// dot() never has to split around the wrap
+
+// a fifo of at most N values
+template <typename T, size_t N>
+class tring
+{
+public:
+  static_assert(N > 0, "tring capacity can't be zero");
+
+  static constexpr size_t capacity() { return N; }
+  static constexpr size_t mask = std::bit_ceil(N) - 1;
+
+  constexpr size_t size() const { return _tail - _head; }
+  constexpr bool empty() const { return _tail == _head; }
+  constexpr bool full() const { return size() == N; }
+
+  // append v_, returning false (and dropping it) if the ring is full
+  constexpr bool push(const T &v_) {
+    if(full()) {
+      return false;
+    }
+    _items[_tail++ & mask] = v_;
+    return true;
+  }
+
+  // append v_, dropping the oldest value if the ring is full
+  constexpr void push_overwrite(const T &v_) {
+    _head += full();
+    _items[_tail++ & mask] = v_;
+  }
+
+  constexpr T pop() { return _items[_head++ & mask]; }
+  constexpr void pop_back() { --_tail; }
+
+  constexpr const T &front() const { return _items[_head & mask]; }
+  constexpr const T &back() const { return _items[(_tail - 1) & mask]; }
+
+  // the i_th oldest value
+  constexpr const T &operator[](size_t i_) const { return _items[(_head + i_) & mask]; }
+
+  constexpr void clear() { _head = _tail = 0; }
+
+private:
+  std::array<T, mask + 1> _items{};
+  size_t _head = 0;
+  size_t _tail = 0;
+};
+
+// the last N values of a stream (zeros before N have been pushed), with a running sum
+template <typename T, size_t N>
+class twindow
+{
+public:
+  static_assert(N > 0, "twindow size can't be zero");
+
+  static constexpr size_t size() { return N; }
+  static constexpr size_t capacity = std::bit_ceil(N);
+  static constexpr size_t mask = capacity - 1;
+
+  constexpr void push(const T &v_) {
+    size_t i = _count & mask;
+    _sum += v_ - _values[(_count - N) & mask];
+    _values[i] = v_;
+    _values[i + capacity] = v_;
+    ++_count;
+  }
+
+  // number of values pushed so far
+  constexpr size_t count() const { return _count; }
+  constexpr bool full() const { return _count >= N; }
+
+  // the window, oldest first
+  constexpr std::span<const T, N> values() const { return std::span<const T, N>(_values.data() + ((_count - N) & mask), N); }
+
+  // the k_th most recent value (0 is the newest)
+  constexpr const T &operator[](size_t k_) const { return _values[(_count - 1 - k_) & mask]; }
+
+  constexpr T sum() const { return _sum; }
+  constexpr T mean() const { return _sum / T(full() ? N : (_count ? _count : 1)); }
+
+  // the sum recomputed over the window (the running sum of floating point values drifts
+  // slowly, as values are added and later subtracted)
+  constexpr T exact_sum() const {
+    T sum = 0;
+    for(T v : values()) {
+      sum += v;
+    }
+    return sum;
+  }
+
+  // sum of COEFS[k] * (k_th most recent value), COEFS being a list of N coefficients
+  template <typename COEFS>
+    constexpr T dot() const {
+    static_assert(COEFS::size() == N, "twindow dot needs one coefficient per value");
+    const T *x = values().data();
+    // four independent accumulators so the loop vectorizes without reassociating
+    T acc[4] = {};
+    size_t i = 0;
+    for( ; i + 4 <= N ; i += 4) {
+      for(size_t j = 0 ; j < 4 ; ++j) {
+	acc[j] += x[i + j] * _reversed<COEFS>[i + j];
+      }
+    }
+    for( ; i < N ; ++i) {
+      acc[0] += x[i] * _reversed<COEFS>[i];
+    }
+    return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+  }
+
+  constexpr void clear() { *this = twindow(); }
+
+private:
+  // coefficients in window order (oldest first)
+  template <typename COEFS>
+    static constexpr std::array<T, N> _reversed = [] {
+    std::array<T, N> r{};
+    COEFS coefs;
+    for(size_t k = 0 ; k < N ; ++k) {
+      r[N - 1 - k] = T(coefs[k]);
+    }
+    return r;
+  }();
+
+  std::array<T, 2 * capacity> _values{};
+  T _sum = 0;
+  size_t _count = 0;
+};
+
+// a window sized to match a list of coefficients
+template <typename COEFS>
+using window_for = twindow<typename COEFS::value_type, COEFS::size()>;
+
+// the running best (by CMP, e.g. the minimum for std::less) of the last N values: a
+// monotonic deque of candidates, each pushed and popped at most once
+template <typename T, size_t N, typename CMP>
+class tmonotonic_window
+{
+public:
+  static constexpr size_t size() { return N; }
+
+  constexpr void push(const T &v_) {
+    while(!_candidates.empty() && !CMP()(_candidates.back().value, v_)) {
+      _candidates.pop_back();
+    }
+    _candidates.push_overwrite({v_, _count});
+    if(_candidates.front().index + N <= _count) {
+      _candidates.pop();
+    }
+    ++_count;
+  }
+
+  // best of the last N values (of those pushed so far, if fewer)
+  constexpr T get() const { return _candidates.front().value; }
+
+  constexpr bool empty() const { return _count == 0; }
+
+private:
+  struct tcandidate {
+    T value;
+    size_t index;
+  };
+
+  tring<tcandidate, N> _candidates;
+  size_t _count = 0;
+};
+
+template <typename T, size_t N>
+using twindow_min = tmonotonic_window<T, N, std::less<>>;
+
+template <typename T, size_t N>
+using twindow_max = tmonotonic_window<T, N, std::greater<>>;
+
+#endif
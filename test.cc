@@ -12,6 +12,28 @@
 // 
 
 #include "static_types.h"
+#include "static_scratch.h"
+#include "static_ema.h"
+#include "static_incremental.h"
+#include "static_tree.h"
+#include "static_mlp.h"
+#include "static_quant.h"
+#include "static_pipeline.h"
+#include "static_bus.h"
+#include "static_fsm.h"
+#include "static_match.h"
+#include "static_regex.h"
+#include "static_decode.h"
+#include "static_fix.h"
+#include "static_compose.h"
+#include "static_freeze.h"
+#include "static_jagged.h"
+#include "static_tensor.h"
+#include "static_poly.h"
+#include "static_any.h"
+#include "static_telemetry.h"
+#include "static_window.h"
+#include "static_kernels.h"
 
 template <double... COEFS>
 class calc
@@ -86,6 +108,440 @@ private:
   double _values[GROUPS::size() * GROUPCOEFS::size()];
 };
 
+//
+// compile-time checks of the other static types -- these cost nothing at runtime,
+// a failure shows up as a build error
+//
+
+static_assert([] {
+    tema<tlist<double, 0.5, 0.25>> ema;
+    ema.update(1.0);
+    tema<tlist<double, 0.5>, true> corrected;
+    corrected.update(4.0);
+    return ema[0] == 0.5 && ema[1] == 0.75 && corrected[0] == 4.0;
+  }());
+
+static_assert([] {
+    tprefix_sum<tlist<double, 0.5, 0.25, 0.125>> prefix;
+    prefix.set(0, 8.0);
+    prefix.set<2>(8.0);
+    touter_sum<tlist<double, 0.5, 0.25>, tlist<uint64_t, 1, 2>> outer;
+    outer.set(1, 4.0);
+    return prefix[0] == 4.0 && prefix[1] == 4.0 && prefix.total() == 5.0 &&
+      outer(0, 1) == 4.0 && outer(1, 1) == 2.0 && outer.total() == 6.0;
+  }());
+
+static_assert([] {
+    typedef touter_sum<tlist<double, 0.5, 0.0, 0.25>, tlist<uint64_t, 1, 0>> sparse;
+    sparse outer;
+    tprefix_sum<tlist<double, 0.5, 0.25, 0.125>> prefix;
+    // every set touches exactly the cells affected() reports
+    return outer.set(0, 4.0) == sparse::affected(0) && sparse::affected(0) == 2 &&
+      outer.set<1>(4.0) == sparse::affected(1) && sparse::affected(1) == 0 && sparse::affected(2) == 0 &&
+      outer.total() == 3.0 && outer(0, 0) == 2.0 && outer(1, 0) == 0.0 && outer(2, 0) == 1.0 &&
+      prefix.set(1, 2.0) == prefix.affected(1) && prefix.affected(1) == 2 &&
+      tprefix_sum<tlist<double, 0.5>>::affected(5) == 0;
+  }());
+
+typedef tnode<0, 1.5, tleaf<1.0>, tnode<1, 0.25, tleaf<2.0>, tleaf<4.0>>> test_tree;
+
+static_assert([] {
+    double rows[] = {1.0, 0.0,  2.0, 0.0,  2.0, 1.0};
+    double scores[3];
+    tforest<ttree_eval::bitmask, test_tree, tleaf<0.5>>::eval_batch(rows, 3, 2, scores);
+    return tforest<ttree_eval::branch, test_tree, tleaf<0.5>>::eval(rows + 4) == 4.5 &&
+      scores[0] == 1.5 && scores[1] == 2.5 && scores[2] == 4.5;
+  }());
+
+static_assert([] {
+    typedef tmlp<tlayer<2, 2, tlist<double, 1.0, 0.0, 0.5, -1.0>, tlist<double, 0.0, 0.5>, trelu>,
+		 tlayer<2, 1, tlist<double, 1.0, 2.0>, tlist<double, -1.0>, tidentity>> net;
+    double in[] = {2.0, 3.0, 1.0, 4.0};
+    double out[2];
+    net::eval_batch(in, 2, out);
+    return out[0] == 1.0 && out[1] == 0.0;
+  }());
+
+static_assert([] {
+    typedef tqlist<tlist<double, 0.5, -0.25, 1.0>, int8_t, 0.004> weights;
+    uint8_t x[3];
+    double in[] = {2.0, 4.0, 1.0};
+    tquantize(in, 3, 1.0, x);
+    return weights::values[2] == 127 && weights::dot(x) == 64 - 64 + 127;
+  }());
+
+static_assert(tqlist<tlist<double, 0.5, -1.0>>::values[1] == -127 && tqlist<tlist<double, 0.5, -1.0>, int16_t>::values[0] == 16384);
+
+struct test_bid { typedef tinputs<> inputs; constexpr double update() { return 99.0; } };
+struct test_ask { typedef tinputs<> inputs; constexpr double update() { return 101.0; } };
+struct test_mid { typedef tinputs<test_bid, test_ask> inputs; constexpr double update(double bid_, double ask_) { return (bid_ + ask_) / 2; } };
+struct test_skew { typedef tinputs<test_mid, test_bid> inputs; constexpr double update(double mid_, double bid_) { return mid_ - bid_; } };
+
+typedef tpipeline<test_skew, test_mid, test_bid, test_ask> test_pipeline;
+
+static_assert(test_pipeline::level_count() == 3 && test_pipeline::level_of<test_skew>() == 2 &&
+	      test_pipeline::level_size(0) == 2);
+
+static_assert([] {
+    test_pipeline pipeline;
+    pipeline.update();
+    return pipeline.get<test_mid>() == 100.0 && pipeline.get<test_skew>() == 1.0;
+  }());
+
+struct test_counter { int count = 0; constexpr void operator()(int n_) { count += n_; } };
+
+static_assert([] {
+    tbus<tsub<tstr("trades"), test_counter>, tsub<tstr("quotes"), test_counter>, tsub<tstr("trades"), test_counter>> bus;
+    bus.publish<tstr("trades")>(2);
+    bus.publish<tstr("quotes")>(5);
+    return bus.subscribers<tstr("trades")>() == 2 &&
+      bus.handler<0>().count == 2 && bus.handler<1>().count == 5 && bus.handler<2>().count == 2;
+  }());
+
+struct test_namer { size_t length = 0; constexpr void operator()(std::string_view name_) { length += name_.size(); } };
+
+static_assert([] {
+    tbus<tsub<tstr("trades"), test_counter>, tsub<tstr("names"), test_namer>> bus;
+    bool published = bus.publish("trades", 3) && bus.publish("names", std::string_view("ES"));
+    // a topic whose handlers can't take the message is the same as no subscriber
+    bool skipped = !bus.publish("trades", std::string_view("ES")) && !bus.publish("names", 3) && !bus.publish("fills", 3);
+    return published && skipped && bus.handler<0>().count == 3 && bus.handler<1>().length == 2;
+  }());
+
+enum class test_state { idle, pending, live, done };
+enum class test_event { send, ack, fill, cancel };
+
+struct test_action { int count = 0; constexpr void operator()() { ++count; } };
+
+typedef tfsm<test_state::idle,
+	     ttransition<test_state::idle, test_event::send, test_state::pending>,
+	     ttransition<test_state::pending, test_event::ack, test_state::live, test_action>,
+	     ttransition<test_state::live, test_event::fill, test_state::done>> test_dense_fsm;
+
+typedef tfsm<test_state::idle,
+	     ttransition<test_state::idle, test_event::send, test_state::pending>,
+	     ttransition<test_state::pending, test_event::ack, test_state::live, test_action>,
+	     ttransition<test_state::live, test_event::cancel, test_state::done>> test_sparse_fsm;
+
+static_assert(test_dense_fsm::dense() && !test_sparse_fsm::dense());
+
+static_assert([] {
+    test_dense_fsm dense;
+    test_sparse_fsm sparse;
+    test_event events[] = {test_event::fill, test_event::send, test_event::ack, test_event::ack, test_event::fill};
+    size_t dense_rejected = dense.process_batch(events, 5);
+    size_t sparse_rejected = sparse.process_batch(events, 5);
+    sparse.process<test_state::live, test_event::cancel>();
+    return dense_rejected == 2 && dense.state() == test_state::done && dense.action<1>().count == 1 &&
+      sparse_rejected == 3 && sparse.state() == test_state::done;
+  }());
+
+typedef tstrlist<tstr("he"), tstr("she"), tstr("his"), tstr("hers")> test_patterns;
+
+static_assert(test_patterns()[0] == "he" && test_patterns()[3] == "hers");
+
+static_assert([] {
+    tmatcher<test_patterns>::stream scan;
+    uint64_t found = 0;
+    size_t ends = 0;
+    size_t count = scan.find_all("ushe", 4, [&](size_t pattern_, size_t end_) { found |= 1 << pattern_; ends += end_; });
+    count += scan.find_all("rs", 2, [&](size_t pattern_, size_t end_) { found |= 1 << pattern_; ends += end_; });
+    return count == 3 && found == 0b1011 && ends == 4 + 4 + 2 &&
+      tmatcher<test_patterns>::contains_any("this") && !tmatcher<test_patterns>::contains_any("hose");
+  }());
+
+static_assert(tregex<tstr("(ES|NQ)[HMUZ][0-9]+")>::match("NQH25") && !tregex<tstr("(ES|NQ)[HMUZ][0-9]+")>::match("NQH"));
+static_assert(tglob<tstr("ES*")>::match("ESZ4") && !tglob<tstr("ES*")>::match("NQZ4"));
+static_assert(tglobset<tstrlist<tstr("ES*"), tstr("*Z4"), tstr("??")>>::match("ESZ4") == 0b011 &&
+	      tglobset<tstrlist<tstr("ES*"), tstr("*Z4"), tstr("??")>>::match("ES") == 0b101);
+
+typedef tschema<tfield<tstr("seq"), 0, uint16_t, tendian::big>,
+		tfield<tstr("qty"), 2, uint16_t, tendian::little>> test_msg;
+
+static_assert([] {
+    const uint8_t msgs[] = {0x01, 0x02, 0x03, 0x04,  0x00, 0x09, 0x0a, 0x00};
+    uint16_t seqs[2];
+    uint16_t qtys[2];
+    test_msg::decode_all(msgs, 2, 4, {seqs, qtys});
+    test_msg::view msg(std::span<const uint8_t>(msgs, 4));
+    return test_msg::bytes() == 4 && msg.get<tstr("seq")>() == 0x0102 && msg.get<tstr("qty")>() == 0x0403 &&
+      seqs[1] == 9 && qtys[1] == 10;
+  }());
+
+static_assert([] {
+    tfix_parser<tlist<int, 35, 44, 38>, '|'> parser;
+    size_t found = parser.parse("8=FIX.4.4|35=D|9999=skip|44=101.25|");
+    return found == 2 && parser.get<35>() == "D" && parser.get(44) == "101.25" && !parser.has<38>();
+  }());
+
+static_assert([] {
+    tfix_parser<tlist<int, 35, 44>, '|'> parser;
+    // 4294967331 is 35 modulo 2^32
+    size_t found = parser.parse("4294967331=evil|99999999999999999999999=x|35=D|");
+    return found == 1 && parser.get<35>() == "D" && !parser.has<44>();
+  }());
+
+enum class test_venue { cme = 1, ice = 2, eurex = 4 };
+
+typedef tmap<int, double, std::pair<tval<5>, tval<0.5>>, std::pair<tval<7>, tval<0.25>>, std::pair<tval<6>, tval<2.0>>> test_dense_map;
+typedef tmap<int, double, std::pair<tval<500>, tval<0.5>>, std::pair<tval<7>, tval<0.25>>, std::pair<tval<-60>, tval<2.0>>> test_sorted_map;
+typedef tmap<test_venue, int64_t,
+	     std::pair<tval<test_venue::eurex>, tlist<int64_t, 1, 2, 3>>,
+	     std::pair<tval<test_venue::cme>, tlist<int64_t, 9>>> test_enum_map;
+
+static_assert(tmap_layout_v<test_dense_map> == tmap_layout::dense && tmap_layout_v<test_sorted_map> == tmap_layout::sorted &&
+	      tmap_layout_v<test_enum_map> == tmap_layout::dense);
+static_assert(test_dense_map()[6] == 2.0 && !test_dense_map::contains(8) &&
+	      test_sorted_map()[-60] == 2.0 && test_sorted_map()[500] == 0.5 && !test_sorted_map::contains(8));
+static_assert(test_enum_map::size(test_venue::eurex) == 3 && test_enum_map()(test_venue::eurex, 2) == 3 &&
+	      !test_enum_map::contains(test_venue::ice));
+
+// keys spread over all of int64_t (or past it, for uint64_t) fall back to the sorted layout
+typedef tmap<int64_t, int, std::pair<tval<INT64_MIN>, tval<1>>, std::pair<tval<INT64_MAX>, tval<2>>> test_wide_map;
+typedef tmap<uint64_t, int, std::pair<tval<uint64_t(3)>, tval<1>>, std::pair<tval<(uint64_t(1) << 63) + 5>, tval<2>>> test_unsigned_map;
+typedef tmap<int64_t, int, std::pair<tval<int64_t(5)>, tval<1>>, std::pair<tval<int64_t(6)>, tval<2>>> test_int64_map;
+
+static_assert(tmap_layout_v<test_wide_map> == tmap_layout::sorted && test_wide_map()[INT64_MIN] == 1 &&
+	      test_wide_map()[INT64_MAX] == 2 && !test_wide_map::contains(0));
+static_assert(tmap_layout_v<test_unsigned_map> == tmap_layout::sorted && test_unsigned_map()[(uint64_t(1) << 63) + 5] == 2 &&
+	      test_unsigned_map()[3] == 1 && !test_unsigned_map::contains(UINT64_MAX));
+static_assert(tmap_layout_v<test_int64_map> == tmap_layout::dense && !test_int64_map::contains(INT64_MIN) &&
+	      test_int64_map()[6] == 2);
+
+static_assert([] {
+    typedef tmap<std::string_view, double, std::pair<tstr("ES"), tval<1.0>>, std::pair<tstr("NQ"), tval<2.0>>> test_string_map;
+    const int dense_keys[] = {6, 8, 5};
+    const int sorted_keys[] = {7, 500, 8, -60};
+    const std::string_view string_keys[] = {"NQ", "CL"};
+    double dense[3] = {};
+    double sorted[4] = {};
+    double strings[2] = {};
+    return test_dense_map().lookup_batch(dense_keys, dense) == 0b010 && dense[0] == 2.0 && dense[2] == 0.5 &&
+      test_sorted_map().lookup_batch(sorted_keys, sorted) == 0b0100 && sorted[1] == 0.5 && sorted[3] == 2.0 &&
+      test_string_map().lookup_batch(string_keys, strings) == 0b10 && strings[0] == 2.0;
+  }());
+
+static_assert([] {
+    const int64_t keys[] = {6, INT64_MIN, 5};
+    int out[3] = {};
+    return test_int64_map().lookup_batch(keys, out) == 0b010 && out[0] == 2 && out[2] == 1;
+  }());
+
+typedef tmap<std::string_view, double,
+	     std::pair<tstr("max_qty"), tval<100.0>>, std::pair<tstr("tick"), tval<0.25>>, std::pair<tstr("lot"), tval<1.0>>> test_defaults;
+typedef tmap<std::string_view, double, std::pair<tstr("tick"), tval<0.01>>> test_venue_config;
+typedef tmap<std::string_view, double, std::pair<tstr("lot"), tval<5.0>>, std::pair<tstr("fee"), tval<0.1>>> test_instrument_config;
+typedef toverride_t<test_defaults, test_venue_config> test_config;
+typedef tmerge_t<test_defaults, test_venue_config, test_instrument_config> test_merged_config;
+typedef tdiff<test_defaults, test_merged_config> test_config_diff;
+
+static_assert(test_config::size() == 3 && test_config()["tick"] == 0.01 && test_config()["max_qty"] == 100.0);
+static_assert(test_merged_config::size() == 4 && test_merged_config()["lot"] == 5.0 && test_merged_config()["fee"] == 0.1);
+static_assert(test_config_diff::added::size() == 1 && test_config_diff::removed::size() == 0 &&
+	      test_config_diff::changed::size() == 2 && test_config_diff::changed()["lot"] == 5.0);
+static_assert(trestrict_t<test_merged_config, tstrlist<tstr("tick"), tstr("fee")>>::size() == 2 &&
+	      !texclude_t<test_merged_config, tstrlist<tstr("tick"), tstr("fee")>>::contains("fee"));
+static_assert(tmap_layout_v<tmerge_t<test_dense_map, tmap<int, double, std::pair<tval<8>, tval<1.0>>>>> == tmap_layout::dense);
+static_assert(std::is_same_v<tmerge_t<tlist<int, 1, 2, 3>, tlist<int, 3, 4>>, tlist<int, 1, 2, 3, 4>> &&
+	      std::is_same_v<tdiff<tlist<int, 1, 2>, tlist<int, 2, 5>>::added, tlist<int, 5>>);
+
+constexpr auto test_ladder = [] {
+  std::vector<double> ladder;
+  for(int i = 0 ; i < 16 ; ++i) {
+    ladder.push_back(1.0 / (1 << (i % 4)));
+  }
+  return ladder;
+};
+
+constexpr auto test_levels = [] {
+  std::vector<std::pair<std::string, std::vector<int>>> levels;
+  for(int i = 1 ; i <= 3 ; ++i) {
+    std::vector<int> sizes;
+    for(int j = 0 ; j < i ; ++j) {
+      sizes.push_back(i * 10 + j);
+    }
+    levels.push_back({"level" + std::string(1, char('0' + i)), sizes});
+  }
+  return levels;
+};
+
+constexpr auto test_symbols = [] { return std::vector<std::string>{"ES", std::string("N") + "Q"}; };
+
+static_assert(tfreeze_v<test_ladder>.size() == 16 && tfreeze_v<test_ladder>[3] == 0.125 &&
+	      std::is_same_v<tfreeze_t<test_ladder>::value_type, double> && tfreeze_t<test_ladder>()[5] == 0.5);
+static_assert(tfreeze_t<test_levels>::size("level3") == 3 && tfreeze_t<test_levels>()("level3", 2) == 32 &&
+	      tfreeze_t<test_symbols>()[1] == "NQ");
+
+typedef tjagged<double, tlist<double, 0.5>, tlist<double, 0.25, 0.5, 1.0>, tlist<double>, tlist<double, 2.0, 4.0>> test_ladders;
+
+static_assert(test_ladders::rows() == 4 && test_ladders::size() == 6 && test_ladders::size(2) == 0 &&
+	      test_ladders()(1, 2) == 1.0 && test_ladders::get<3, 1>() == 4.0);
+static_assert(test_ladders::row(1).size() == 3 && test_ladders::row<3>().extent == 2 && test_ladders::row<3>()[0] == 2.0);
+static_assert([] {
+    constexpr auto rows = [] { return std::vector<std::vector<int>>{{1}, {}, {2, 3}}; };
+    return tfreeze_t<rows>::rows() == 3 && tfreeze_t<rows>()(2, 1) == 3;
+  }());
+
+typedef tlist<int, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12> test_grid_values;
+typedef ttensor<test_grid_values, tshape<2, 3, 2>> test_grid;
+typedef ttensor<test_grid_values, tshape<2, 3, 2>, tblocked<2, 2>> test_blocked_grid;
+
+static_assert(test_grid()(1, 2, 0) == 11 && test_grid::get<0, 1, 1>() == 4 && test_blocked_grid()(1, 2, 0) == 11 &&
+	      test_blocked_grid::values[1] == 2 && test_blocked_grid::desc.strides[0] == 6);
+static_assert(test_grid::slice<1>(2)(1, 1) == 12 && test_blocked_grid::slice<2>(1).slice<0>(1)(0) == 8);
+static_assert(test_grid::sum<0>() == std::array<int, 6>{8, 10, 12, 14, 16, 18} &&
+	      test_grid::max<1>() == std::array<int, 4>{5, 6, 11, 12} &&
+	      test_blocked_grid::sum<2>() == std::array<int, 6>{3, 7, 11, 15, 19, 23});
+
+struct test_scalar_model { int value = 1; };
+struct test_batched_model {
+  int value = 2;
+  constexpr void update_batch() { value *= 10; }
+};
+
+template <typename T>
+using test_batched = std::bool_constant<requires(T &t) { t.update_batch(); }>;
+
+typedef thlist<test_batched_model, test_scalar_model, test_batched_model, int> test_models;
+
+static_assert(test_models::count_of<test_batched_model>() == 2 && test_models::index_of<int>() == 3 &&
+	      std::is_same_v<test_models::filter<test_batched>, thlist<test_batched_model, test_batched_model>> &&
+	      std::is_same_v<test_models::partition<test_batched>::second_type, thlist<test_scalar_model, int>> &&
+	      std::is_same_v<test_models::unique, thlist<test_batched_model, test_scalar_model, int>>);
+static_assert([] {
+    test_models models;
+    int sum = 0;
+    models.visit_if<test_batched>([&sum](auto &m) { m.update_batch(); sum += m.value; });
+    models.visit_each<test_scalar_model>([&sum](auto &m) { sum += m.value; });
+    return sum + models.get<test_scalar_model>().value + models.get<2>().value;
+  }() == 20 + 20 + 1 + 1 + 20);
+
+static_assert([] {
+    tpoly<test_scalar_model, test_batched_model> models;
+    models.emplace<test_batched_model>();
+    models.insert(test_scalar_model{3});
+    models.insert(test_batched_model{4});
+    int order = 0;
+    models.visit([&order](const auto &m) { order = order * 10 + m.value; });
+    models.visit_if<test_batched>([](auto &m) { m.update_batch(); });
+    models.erase<test_batched_model>(0);
+    return order == 324 && models.size() == 2 && models.segment<test_batched_model>()[0].value == 40;
+  }());
+
+struct test_linear_model {
+  double slope = 2;
+  constexpr double update(double x_) { return slope * x_; }
+};
+
+struct test_square_model {
+  constexpr double update(double x_) { return x_ * x_; }
+};
+
+typedef tany<thlist<test_linear_model, test_square_model>> test_any_model;
+
+static_assert(sizeof(test_any_model) == 2 * sizeof(double));
+static_assert([] {
+    test_any_model model = test_square_model();
+    test_any_model copy = model;
+    copy.emplace<test_linear_model>(3.0);
+    test_any_model empty;
+    return model.update(3.0) == 9.0 && copy.update(3.0) == 9.0 && copy.holds<test_linear_model>() &&
+      copy.visit([](auto &m) { return sizeof(m); }) == sizeof(double) && !empty.has_value() &&
+      model.get_if<test_linear_model>() == nullptr;
+  }());
+
+// calc3 with its working memory moved out: the parameters are all that's left in the
+// object, and update is const, so one instance can be shared by threads
+template <typename GROUPS, typename GROUPDEFS, typename GROUPCOEFS>
+class shared_calc3 {
+public:
+  typedef tscratch<double, GROUPS::size() * GROUPCOEFS::size()> scratch_type;
+
+  constexpr double update(scratch_type &values_) const {
+    double sum = 0;
+    size_t ctr = 0;
+    for(size_t i = 0 ; i < _groups.size() ; ++i) {
+      size_t tctr = 0;
+      std::string_view group = _groups[i];
+      for(size_t ni = 0 ; ni < _groupdefs.size(group) ; ++ni) {
+	if(_groupdefs(group, ni) == "baz") {
+	  ++tctr;
+	}
+      }
+      for(size_t j = 0 ; j < _coefs.size() ; ++j) {
+	sum += tctr * _coefs[j];
+	values_[ctr++] = sum;
+      }
+    }
+    return values_[ctr-1];
+  }
+
+  constexpr double update() const { return tupdate(*this); }
+
+private:
+  GROUPS _groups;
+  GROUPDEFS _groupdefs;
+  GROUPCOEFS _coefs;
+};
+
+typedef shared_calc3<tstrlist<tstr("chicken"), tstr("beef")>,
+		     tmap<std::string_view, std::string_view,
+			  std::pair<tstr("chicken"), tstrlist<tstr("foo"), tstr("bar")>>,
+			  std::pair<tstr("beef"), tstrlist<tstr("baz"), tstr("bat")>>>,
+		     tlist<double, 0.5, 0.25>> test_calc3;
+
+static_assert(tuses_scratch<test_calc3> && !tuses_scratch<calc<0.5>> &&
+	      std::is_same_v<tscratch_t<test_calc3>, tscratch<double, 4>>);
+static_assert([] {
+    const test_calc3 shared;
+    tscratch_set<test_calc3, test_linear_model> scratch;
+    return shared.update() == 0.75 && scratch.update(shared) == 0.75 && tupdate(shared) == 0.75;
+  }());
+
+typedef tcounters<tstrlist<tstr("updates"), tstr("rejects")>> test_counters;
+typedef thistogram<thdr_bounds<2, 1000>> test_latency;
+
+static_assert(test_counters::index_of<tstr("rejects")>() == 1 && test_latency::bounds.back() == 1024);
+static_assert(test_latency::bounds[4] == 5 && test_latency::bounds[8] == 10 && test_latency::bucket_of(0) == 0 &&
+	      test_latency::bucket_of(9) == 8 && test_latency::bucket_of(11) == 9 && test_latency::bucket_of(5000) == test_latency::buckets() - 1);
+
+typedef tlist<double, 0.5, 0.25, 0.125> test_fir;
+
+constexpr double test_window()
+{
+  window_for<test_fir> w;
+  twindow_max<int, 3> hi;
+  tring<int, 3> r;
+  double y = 0;
+  for(int x : {4, 8, 2, 6, 1}) {
+    w.push(x);
+    hi.push(x);
+    r.push_overwrite(x);
+    y += hi.get() + r.front();
+  }
+  // 4 8 2 6 1 -> dot 1 * 0.5 + 6 * 0.25 + 2 * 0.125, maxes 4 8 8 8 6, fronts 4 4 4 8 2
+  return w.dot<test_fir>() + w.sum() + y;
+}
+
+static_assert(window_for<test_fir>::capacity == 4 && tring<int, 5>::mask == 7 && test_window() == 2.25 + 9 + 34 + 22);
+
+typedef tstrlist<tstr("chicken"), tstr("beef"), tstr("pork")> test_meats;
+
+constexpr double test_kernels()
+{
+  double x[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+  typedef tlist<double, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 0.5> weights;
+  size_t letters = 0;
+  tfor_each<test_meats>([&letters](std::string_view s) { letters += s.size(); });
+  tfor_each<test_meats, false>([&letters](std::string_view s) { letters += s.size(); });
+  return tdot<weights, true>(x) + tdot<weights, false>(x) + letters;
+}
+
+static_assert(test_kernels() == 50 + 50 + 30 && tcontains<test_meats, true>(std::string_view("beef")) &&
+	      tcontains<test_meats, false>(std::string_view("pork")) && !tcontains<test_meats, false>(std::string_view("lamb")));
+static_assert(tcontains<tlist<int, 3, 5, 8>, false>(8) && !tcontains<tlist<int, 3, 5, 8>, true>(4) &&
+	      tsum<tlist<int, 1, 2, 3>, false>([](int v) { return v * v; }) == 14);
+
 int main(int argc, char **argv)
 {  
   calc<0.9999, 0.998, 0.9333, 0.5> instance;